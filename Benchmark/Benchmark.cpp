@@ -8,249 +8,1809 @@
 #include <execution>
 #include <numeric>
 #include <algorithm>
+#include <thread>
+#include <latch>
+#include <atomic>
+#include <map>
+#include <fstream>
+#include <memory>
+#include <limits>
+#include <string_view>
+#include <optional>
+#include <functional>
 #include "Poker.h"
+#include "ThreadPool.h"
+#include "Numa.h"
+#include "EvalService.h"
+#include "HandFile.h"
+#include "Exhaustive.h"
+#include "EvalCounters.h"
+#include "LatencyHistogram.h"
+#include "PerfCounters.h"
+#include "Tsc.h"
+#include "Harness.h"
+#include "Evaluators.h"
+#include "BitSliced.h"
+#include "Reorder.h"
+#include "Table7.h"
 
 /****************************************************************
     Poker Hand Evaluator Benchmark
 
-    Tests performance by evaluating random poker hands and
-    calculating hands evaluated per second.
-    
-    Configure CARD_COUNT below to switch between 5-card and 7-card evaluation.
+    A command-line harness (Benchmark --help): card count,
+    evaluators, thread counts, hand counts and repetitions are all
+    chosen at run time. Every measurement is repeated and reported
+    as median and MAD; hand generation is timed separately from
+    evaluation; --json writes everything for comparing builds and
+    hosts.
+
+    Modes (--mode, default throughput):
+
+    throughput    deal (or --input) every hand into one vector, then
+                  time each evaluator over it on each thread count
+    stream        each worker deals into a small cache-resident
+                  buffer, evaluates it and folds the results before
+                  refilling; the hands are the ones throughput uses
+                  for the same seed, so the checksums must agree
+    scaling       parallel_evaluate on the thread pool vs
+                  std::execution::par, on a large batch and on
+                  repeated small batches
+    numa          per-node lookup tables, pinned workers and
+                  node-local input; throughput per node and overall
+    service       producer threads submit uneven bursts of hands to
+                  EvalService; batching, queue depth and latency
+    distribution  hand categories observed vs the exact odds
+    latency       single calls (or --group calls) timed with the TSC
+                  on one thread, as percentiles per hand category
+    paths         the Cactus Kev evaluator instrumented with
+                  EvalCounters: share of each eval_5cards path, the
+                  eval_7hand early exit and table cache-line spread,
+                  plus the instrumented throughput
+    workingset    the same hands with the input working set doubled
+                  from --ws-min to --ws-max, so the curve shows where
+                  evaluation turns cache- or DRAM-bound; plus hands
+                  regenerated into an L1-resident buffer per call
+    prefetch      pipelined evaluators at each --lookahead distance,
+                  0 being their plain scalar loop
+    bitslice      the bit-sliced evaluator head to head with Cactus
+                  Kev on one thread, split into transpose, boolean
+                  logic and the transpose back to values
+    branches      every evaluator on random (or --input) hands and on
+                  the same hands grouped by category, where branches
+                  predict well; run with --perf for branch misses
+    reorder       lookups into tables from 32 KB to 512 MB with and
+                  without LocalityReorder's bucketing pre-pass, to
+                  find where reordering starts to pay off
+    table7        7-card lookups in the precomputed colex-rank table
+                  (--table7 file, else built in memory) against every
+                  computed 7-card evaluator
+    noisy         every evaluator in batches of 1,024 hands, each batch
+                  after a pass over a private --noise buffer, as a
+                  co-located workload would leave the caches
+    hugepages     every evaluator over hand buffers on 4 KB and on huge
+                  pages, plus Table7 mapped vs copied to huge pages with
+                  --table7; run with --perf for dTLB misses
+
+    --perf adds Linux hardware counters per hand (cycles, IPC, L1d,
+    LLC, branch and dTLB misses) for hand generation and for each
+    throughput, stream, prefetch and branches row, from one extra
+    untimed run.
 ****************************************************************/
 
 using namespace poker;
+using namespace bench;
 using namespace std::chrono;
 
-// Configuration: Set to 5 or 7 to choose evaluation type
-constexpr int CARD_COUNT = 5;
+// Largest hand vector throughput mode may allocate; bigger counts only stream
+constexpr unsigned long long MAX_MATERIALIZED_BYTES = 8ULL << 30;
 
-// Generate random poker hands from a deck
-template<int N>
-std::vector<std::array<int, N>> generate_test_hands(int count) {
-    std::vector<std::array<int, N>> hands(count);
-    auto deck = init_deck();
-
-    std::for_each(std::execution::par_unseq, hands.begin(), hands.end(),
-        [&deck](auto& hand) {
-            thread_local std::mt19937 gen(std::random_device{}());
-
-            // Create indices array fresh each time
-            std::array<int, 52> indices;
-            std::iota(indices.begin(), indices.end(), 0);
-
-            // Partial Fisher-Yates shuffle
-            for (int j = 0; j < N; ++j) {
-                std::uniform_int_distribution<int> dist(j, 51);
-                int swap_idx = dist(gen);
-                std::swap(indices[j], indices[swap_idx]);
-                hand[j] = deck[indices[j]];
+// Hands per worker buffer in stream mode (80 KB of 5-card, 112 KB of 7-card hands)
+constexpr size_t STREAM_BUFFER_HANDS = 4096;
+
+// Scaling mode: small batch size and number of calls per measurement
+constexpr int SMALL_BATCH_HANDS = 10'000;
+constexpr int SMALL_BATCH_CALLS = 1'000;
+
+// Service mode: total requests and largest burst a producer submits at once
+constexpr int SERVICE_REQUESTS = 1'000'000;
+constexpr int SERVICE_MAX_BURST = 64;
+
+// Distribution mode: hands dealt per evaluator
+constexpr long long DISTRIBUTION_HANDS = 1'000'000;
+
+// Latency mode: hands timed per evaluator when --hands is not given
+constexpr long long LATENCY_HANDS = 1'000'000;
+
+// Working-set mode: hands dealt per call when inputs are regenerated
+constexpr size_t REGENERATED_HANDS = 64;
+
+// Reorder mode: hands per reordered batch, synthetic table sizes, and the
+// table bytes each bucket covers
+constexpr size_t REORDER_BATCH_HANDS = 1 << 16;
+constexpr std::array<size_t, 6> REORDER_TABLE_BYTES = {
+    32 << 10, 256 << 10, 2 << 20, 16 << 20, 128 << 20, 512 << 20
+};
+constexpr size_t REORDER_REGION_BYTES = 256 << 10;
+
+// Noisy mode: hands between two passes over the noise buffer (the work a
+// co-located workload does between evaluator calls), and hands per run
+constexpr size_t NOISE_BATCH_HANDS = 1024;
+constexpr long long NOISE_HANDS = 512 * 1024;
+
+// Exact 5-card category counts out of C(52,5), indexed by hand_rank
+constexpr std::array<uint64_t, 10> expected_freq5 = {
+    0, 40, 624, 3'744, 5'108, 10'200, 54'912, 123'552, 1'098'240, 1'302'540
+};
+constexpr uint64_t TOTAL_5CARD_HANDS = 2'598'960;
+
+// Thread pools by thread count, created on first use
+class Pools {
+public:
+    explicit Pools(bool pin) : pin_(pin) {}
+
+    ThreadPool& get(unsigned threads)
+    {
+        auto& pool = pools_[threads];
+        if (!pool)
+            pool = std::make_unique<ThreadPool>(PoolOptions{ .threads = threads, .pin_threads = pin_ });
+        return *pool;
+    }
+
+private:
+    bool pin_;
+    std::map<unsigned, std::unique_ptr<ThreadPool>> pools_;
+};
+
+// What every mode needs for one card count
+struct Context {
+    const Options& opt;
+    int cards;
+    const HandFile* input;
+    Pools& pools;
+    std::vector<Result>& results;
+    const PerfCounters* perf;                 // null without --perf
+    PerfSnapshot generation_counters{};       // of the last hands() call
+    ProcessUsage generation_usage{};          // of the last hands() call: page faults
+
+    [[nodiscard]] unsigned hardware_threads() const { return std::max(1u, std::thread::hardware_concurrency()); }
+
+    [[nodiscard]] std::vector<long long> hand_counts() const
+    {
+        if (!opt.hands.empty()) return opt.hands;
+        if (input) return { static_cast<long long>(input->size()) };
+        return { cards == 5 ? DEFAULT_HANDS_5 : DEFAULT_HANDS_7 };
+    }
+
+    [[nodiscard]] std::vector<const Evaluator*> evaluators() const { return select_evaluators(cards, opt.evaluators); }
+
+    // Deal (or load) count hands, on huge pages with --huge-pages on;
+    // generation_ns receives the time it took
+    [[nodiscard]] HandSet hands(long long count, double& generation_ns)
+    {
+        return hands(count, generation_ns, opt.huge_pages ? HugePages::On : HugePages::Off);
+    }
+
+    [[nodiscard]] HandSet hands(long long count, double& generation_ns, HugePages pages)
+    {
+        ThreadPool& pool = pools.get(hardware_threads());
+        const PerfSnapshot before = perf ? perf->read() : PerfSnapshot{};
+        const ProcessUsage usage_before = ProcessUsage::now();
+        const auto start = steady_clock::now();
+        HandSet set = input ? load_hands(*input, count, pages) : generate_hands(cards, count, opt.seed, pool, pages);
+        generation_ns = static_cast<double>(duration_cast<nanoseconds>(steady_clock::now() - start).count());
+        generation_usage = ProcessUsage::now() - usage_before;
+        if (perf) generation_counters = perf->read() - before;
+        return set;
+    }
+};
+
+// Row names "<evaluator><suffix>" of the selected evaluators
+std::vector<std::string> evaluator_names(const Context& ctx, std::string_view suffix = "")
+{
+    std::vector<std::string> names;
+    for (const Evaluator* e : ctx.evaluators())
+        names.push_back(std::format("{}{}", e->name, suffix));
+    return names;
+}
+
+// Mark the result inconsistent unless every run produced the same checksum
+void set_checksum(Result& r, const std::vector<unsigned long long>& sums)
+{
+    r.checksum = sums.empty() ? 0 : sums.front();
+    r.checksum_consistent = std::all_of(sums.begin(), sums.end(),
+        [&](unsigned long long s) { return s == r.checksum; });
+}
+
+/****************************************************************
+    Hardware counters
+****************************************************************/
+
+// Print counts per hand and add them to r's metrics as "<prefix><event>_per_hand"
+void report_counters(Result& r, const PerfSnapshot& d, double hands, std::string_view label, const std::string& prefix = "")
+{
+    std::string line;
+    for (int i = 0; i < NUM_PERF_EVENTS; ++i) {
+        const auto name = perf_event_names[i];
+        if (!d.valid[i]) {
+            line += std::format("  {} n/a", name);
+            continue;
+        }
+        line += std::format("  {} {:.3f}", name, d.counts[i] / hands);
+        r.metrics.emplace_back(prefix + std::string(name) + "_per_hand", d.counts[i] / hands);
+    }
+    if (d.has(PerfEvent::Cycles) && d.has(PerfEvent::Instructions) && d[PerfEvent::Cycles] > 0) {
+        const double ipc = d[PerfEvent::Instructions] / d[PerfEvent::Cycles];
+        line += std::format("  IPC {:.2f}", ipc);
+        r.metrics.emplace_back(prefix + "ipc", ipc);
+    }
+    std::println("    {} per hand:{}", label, line);
+}
+
+// Run fn once more, untimed, under the hardware counters and report them per hand
+template<typename Fn>
+void count_events(const Context& ctx, Result& r, Fn&& fn)
+{
+    if (!ctx.perf) return;
+    const PerfSnapshot before = ctx.perf->read();
+    fn();
+    report_counters(r, ctx.perf->read() - before, static_cast<double>(r.hands), "evaluation");
+}
+
+/****************************************************************
+    Throughput: evaluate a materialised hand vector
+****************************************************************/
+
+unsigned long long evaluate_all(ThreadPool& pool, const Evaluator& e, const HandSet& hands)
+{
+    struct alignas(64) Partial { unsigned long long sum = 0; };
+    std::vector<Partial> partial(pool.size());
+    pool.parallel_for(hands.size(), [&](size_t b, size_t end, unsigned w) {
+        partial[w].sum += e.checksum(hands.hand(b), end - b);
+    });
+    unsigned long long sum = 0;
+    for (const auto& p : partial)
+        sum += p.sum;
+    return sum;
+}
+
+void run_throughput(Context& ctx)
+{
+    for (long long count : ctx.hand_counts()) {
+        const unsigned long long bytes = static_cast<unsigned long long>(count) * ctx.cards * sizeof(int);
+        std::println("\n=== Throughput: {}-card, {:L} hands ===", ctx.cards, count);
+        if (bytes > MAX_MATERIALIZED_BYTES) {
+            std::println("  skipped: {:.1f} GB of hands exceeds the {:.1f} GB limit (use --mode stream)",
+                bytes / 1e9, MAX_MATERIALIZED_BYTES / 1e9);
+            continue;
+        }
+
+        double generation_ns = 0;
+        const HandSet hands = ctx.hands(count, generation_ns);
+        std::println("  {} in {:.3f} s, {:L} page faults", ctx.input ? "Loaded" : "Generated", generation_ns / 1e9,
+            ctx.generation_usage.page_faults());
+        const size_t width = name_width(evaluator_names(ctx));
+        print_table_header(width);
+
+        for (const Evaluator* e : ctx.evaluators()) {
+            for (unsigned threads : ctx.opt.threads) {
+                ThreadPool& pool = ctx.pools.get(threads);
+                Result r{ "throughput", std::string(e->name), ctx.cards, threads, count, generation_ns };
+                r.metrics.emplace_back("generation_page_faults", static_cast<double>(ctx.generation_usage.page_faults()));
+                std::vector<unsigned long long> sums;
+                r.samples_ns = measure(ctx.opt, [&] { sums.push_back(evaluate_all(pool, *e, hands)); });
+                set_checksum(r, sums);
+                print_row(r, width);
+                if (ctx.perf) {
+                    report_counters(r, ctx.generation_counters, static_cast<double>(count), "generation", "generation_");
+                    count_events(ctx, r, [&] { evaluate_all(pool, *e, hands); });
+                }
+                ctx.results.push_back(std::move(r));
             }
         }
-    );
+    }
+}
+
+/****************************************************************
+    Stream: generation, evaluation and reduction fused per worker
+****************************************************************/
+
+// Per-worker results of a streamed run, padded so workers never share a cache line
+struct alignas(64) StreamTotals {
+    unsigned long long checksum = 0;
+    std::array<unsigned long long, 10> freq{};
+};
+
+// Deals the same hands as generate_hands, a buffer at a time, so no
+// hand vector is ever materialised.
+StreamTotals stream_evaluate(ThreadPool& pool, const Evaluator& e, long long count, uint64_t seed)
+{
+    const Deck deck = init_deck();
+    const size_t total = static_cast<size_t>(count);
+    const size_t blocks = (total + GENERATION_BLOCK - 1) / GENERATION_BLOCK;
+    std::vector<StreamTotals> partial(pool.size());
+
+    pool.parallel_for(blocks, [&](size_t b, size_t end, unsigned w) {
+        std::vector<int> buffer(STREAM_BUFFER_HANDS * e.cards);
+        std::vector<unsigned short> values(STREAM_BUFFER_HANDS);
+        StreamTotals local = partial[w];
 
-    return hands;
+        for (size_t block = b; block < end; ++block) {
+            std::mt19937_64 gen(block_seed(seed, block));
+            const size_t first = block * GENERATION_BLOCK;
+            const size_t last = std::min(total, first + GENERATION_BLOCK);
+            for (size_t i = first; i < last; i += STREAM_BUFFER_HANDS) {
+                const size_t n = std::min(STREAM_BUFFER_HANDS, last - i);
+                for (size_t k = 0; k < n; ++k)
+                    deal_hand(buffer.data() + k * e.cards, e.cards, deck, gen);
+                e.values(buffer.data(), n, values.data());
+                for (size_t k = 0; k < n; ++k) {
+                    local.checksum += values[k];
+                    ++local.freq[hand_rank(values[k])];
+                }
+            }
+        }
+        partial[w] = local;
+    });
+
+    StreamTotals sum;
+    for (const auto& p : partial) {
+        sum.checksum += p.checksum;
+        for (int i = 0; i < 10; ++i)
+            sum.freq[i] += p.freq[i];
+    }
+    return sum;
 }
 
-// Wrapper function to evaluate hands based on card count
+void run_stream(Context& ctx)
+{
+    if (ctx.input) {
+        std::println("\n=== Stream: skipped, it always deals random hands (--input given) ===");
+        return;
+    }
+
+    for (long long count : ctx.hand_counts()) {
+        std::println("\n=== Stream: {}-card, {:L} hands, {} hands per buffer, includes generation ===",
+            ctx.cards, count, STREAM_BUFFER_HANDS);
+        const size_t width = name_width(evaluator_names(ctx));
+        print_table_header(width);
+
+        StreamTotals last;
+        for (const Evaluator* e : ctx.evaluators()) {
+            for (unsigned threads : ctx.opt.threads) {
+                ThreadPool& pool = ctx.pools.get(threads);
+                Result r{ "stream", std::string(e->name), ctx.cards, threads, count };
+                std::vector<unsigned long long> sums;
+                r.samples_ns = measure(ctx.opt, [&] {
+                    last = stream_evaluate(pool, *e, count, ctx.opt.seed);
+                    sums.push_back(last.checksum);
+                });
+                set_checksum(r, sums);
+                for (int i = 1; i <= 9; ++i)
+                    r.metrics.emplace_back(value_str[i], static_cast<double>(last.freq[i]));
+                print_row(r, width);
+                count_events(ctx, r, [&] { stream_evaluate(pool, *e, count, ctx.opt.seed); });
+                ctx.results.push_back(std::move(r));
+            }
+        }
+
+        std::println("\n  Streamed hand distribution:");
+        for (int i = 1; i <= 9; ++i)
+            std::println("  {:>15s}: {:12d} ({:5.2f}%)", value_str[i], last.freq[i], last.freq[i] * 100.0 / count);
+    }
+}
+
+/****************************************************************
+    Scaling: thread pool vs std::execution::par
+****************************************************************/
+
 template<int N>
-unsigned short evaluate_hand(std::span<const int> hand) {
-    if constexpr (N == 5) {
-        return eval_5hand(hand);
-    } else if constexpr (N == 7) {
-        return eval_7hand(hand);
-    } else {
-        static_assert(N == 5 || N == 7, "Only 5-card and 7-card evaluation supported");
+void run_scaling(Context& ctx, const HandSet& hands, double generation_ns)
+{
+    using HandN = std::array<int, N>;
+    const std::span<const HandN> batch{ reinterpret_cast<const HandN*>(hands.data()), hands.size() };
+    const long long count = static_cast<long long>(batch.size());
+
+    auto par_sum = [](std::span<const HandN> b) {
+        return std::transform_reduce(std::execution::par, b.begin(), b.end(),
+            0ULL, std::plus<unsigned long long>{},
+            [](const HandN& hand) -> unsigned long long {
+                if constexpr (N == 5) return eval_5hand(hand);
+                else return eval_7hand(hand);
+            });
+    };
+
+    const size_t width = name_width({ "thread_pool", "std::execution::par" });
+    print_table_header(width);
+    for (unsigned threads : ctx.opt.threads) {
+        ThreadPool& pool = ctx.pools.get(threads);
+        Result r{ "scaling", "thread_pool", N, threads, count, generation_ns };
+        std::vector<unsigned long long> sums;
+        r.samples_ns = measure(ctx.opt, [&] { sums.push_back(parallel_evaluate(pool, batch, ChecksumReducer{}).sum); });
+        set_checksum(r, sums);
+        print_row(r, width);
+        ctx.results.push_back(std::move(r));
     }
+
+    Result par{ "scaling", "std::execution::par", N, ctx.hardware_threads(), count, generation_ns };
+    std::vector<unsigned long long> par_sums;
+    par.samples_ns = measure(ctx.opt, [&] { par_sums.push_back(par_sum(batch)); });
+    set_checksum(par, par_sums);
+    print_row(par, width);
+    ctx.results.push_back(std::move(par));
+
+    // Per-call overhead on small batches
+    const auto small = batch.first(std::min<size_t>(batch.size(), SMALL_BATCH_HANDS));
+    ThreadPool& pool = ctx.pools.get(ctx.opt.threads.back());
+    std::println("\n  {} calls x {} hands:", SMALL_BATCH_CALLS, small.size());
+
+    auto small_result = [&](std::string name, unsigned threads, auto&& call) {
+        Result r{ "scaling_small_batch", std::move(name), N, threads,
+                  static_cast<long long>(small.size()) * SMALL_BATCH_CALLS, generation_ns };
+        std::vector<unsigned long long> sums;
+        r.samples_ns = measure(ctx.opt, [&] {
+            unsigned long long sum = 0;
+            for (int i = 0; i < SMALL_BATCH_CALLS; ++i)
+                sum += call();
+            sums.push_back(sum);
+        });
+        set_checksum(r, sums);
+        const double us_per_call = r.summary().median / 1e3 / SMALL_BATCH_CALLS;
+        r.metrics.emplace_back("us_per_call", us_per_call);
+        std::println("    {:<20s} {:.2f} us per call", r.evaluator + ":", us_per_call);
+        ctx.results.push_back(std::move(r));
+    };
+    small_result("thread_pool", pool.size(), [&] { return parallel_evaluate(pool, small, ChecksumReducer{}).sum; });
+    small_result("std::execution::par", ctx.hardware_threads(), [&] { return par_sum(small); });
 }
 
-int main() {
-    std::println("=== {}-Card Poker Hand Evaluator Benchmark ===\n", CARD_COUNT);
+/****************************************************************
+    NUMA: node-local tables, workers and input
+****************************************************************/
+
+template<int N>
+void run_numa(Context& ctx, long long n)
+{
+    const auto nodes = numa_topology();
+    size_t total_cpus = 0;
+    for (const auto& node : nodes)
+        total_cpus += node.cpus.size();
+
+    std::println("\n=== NUMA: {}-card, {:L} hands, {} node(s), {} CPUs ===", N, n, nodes.size(), total_cpus);
+
+    using HandN = std::array<int, N>;
+    struct NodeRun {
+        std::unique_ptr<NodeTables> tables;
+        HandN* hands = nullptr;
+        size_t count = 0;
+        std::atomic<unsigned long long> checksum{ 0 };
+
+        ~NodeRun() { numa_free(hands, count * sizeof(HandN)); }
+    };
+    std::vector<NodeRun> runs(nodes.size());
 
-    // Warm-up run
-    std::println("Warming up...");
-    if constexpr (CARD_COUNT == 5) {
-        auto warmup_hands = generate_test_hands<5>(10000);
-        for (auto& hand : warmup_hands) {
-            volatile auto result = evaluate_hand<5>(std::span{ hand });
-            (void)result; // Prevent optimization
+    // Share the hands in proportion to each node's CPU count
+    long long assigned = 0;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        runs[i].count = (i + 1 == nodes.size()) ? n - assigned
+            : static_cast<size_t>(n * nodes[i].cpus.size() / total_cpus);
+        assigned += runs[i].count;
+        runs[i].tables = std::make_unique<NodeTables>(nodes[i]);
+        runs[i].hands = static_cast<HandN*>(numa_alloc(runs[i].count * sizeof(HandN), nodes[i].id));
+        if (runs[i].count && !runs[i].hands)
+            throw std::runtime_error(std::format("numa: cannot map {:L} bytes of hands on node {}",
+                runs[i].count * sizeof(HandN), nodes[i].id));
+    }
+
+    // Run fn(node, worker, workers) on every node at once
+    auto on_all_nodes = [&](auto&& fn) {
+        std::vector<std::thread> drivers;
+        for (size_t i = 0; i < nodes.size(); ++i)
+            drivers.emplace_back([&, i] {
+                run_on_node(nodes[i], [&](unsigned w, unsigned workers) { fn(i, w, workers); });
+            });
+        for (auto& d : drivers)
+            d.join();
+    };
+
+    // Generate: each node's workers first-touch their own slice
+    const auto gen_start = steady_clock::now();
+    const Deck deck = init_deck();
+    on_all_nodes([&](size_t i, unsigned w, unsigned workers) {
+        std::mt19937_64 gen(block_seed(ctx.opt.seed, i * 1'024 + w));
+        const size_t b = runs[i].count * w / workers;
+        const size_t e = runs[i].count * (w + 1) / workers;
+        for (size_t k = b; k < e; ++k)
+            deal_hand(runs[i].hands[k].data(), N, deck, gen);
+    });
+    const double generation_ns = static_cast<double>(duration_cast<nanoseconds>(steady_clock::now() - gen_start).count());
+
+    // Evaluate: node-local hands against node-local tables. Each node's
+    // time runs from its first worker's start to its last worker's end.
+    std::vector<std::vector<double>> node_samples(nodes.size());
+    std::vector<unsigned long long> sums;
+    std::vector<double> all_samples = measure(ctx.opt, [&] {
+        std::latch ready(static_cast<ptrdiff_t>(total_cpus));
+        std::vector<std::atomic<long long>> node_start(nodes.size());
+        std::vector<std::atomic<long long>> node_end(nodes.size());
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            node_start[i] = std::numeric_limits<long long>::max();
+            node_end[i] = 0;
+            runs[i].checksum = 0;
         }
-    } else {
-        auto warmup_hands = generate_test_hands<7>(10000);
-        for (auto& hand : warmup_hands) {
-            volatile auto result = evaluate_hand<7>(std::span{ hand });
-            (void)result; // Prevent optimization
+
+        on_all_nodes([&](size_t i, unsigned w, unsigned workers) {
+            const TableSet& tables = runs[i].tables->tables();
+            const size_t b = runs[i].count * w / workers;
+            const size_t e = runs[i].count * (w + 1) / workers;
+            ready.arrive_and_wait();
+
+            const long long t0 = steady_clock::now().time_since_epoch().count();
+            unsigned long long sum = 0;
+            for (size_t k = b; k < e; ++k) {
+                if constexpr (N == 5)
+                    sum += eval_5hand(tables, runs[i].hands[k]);
+                else
+                    sum += eval_7hand(tables, runs[i].hands[k]);
+            }
+            const long long t1 = steady_clock::now().time_since_epoch().count();
+
+            runs[i].checksum += sum;
+            for (long long cur = node_start[i]; t0 < cur && !node_start[i].compare_exchange_weak(cur, t0); ) {}
+            for (long long cur = node_end[i]; t1 > cur && !node_end[i].compare_exchange_weak(cur, t1); ) {}
+        });
+
+        unsigned long long checksum = 0;
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            node_samples[i].push_back(static_cast<double>(duration_cast<nanoseconds>(
+                steady_clock::duration(node_end[i] - node_start[i])).count()));
+            checksum += runs[i].checksum;
         }
+        sums.push_back(checksum);
+    });
+
+    // measure() also ran the warmups; keep only the timed repetitions
+    std::vector<std::string> names{ "aggregate" };
+    for (const auto& node : nodes)
+        names.push_back(std::format("node{}", node.id));
+    const size_t width = name_width(names);
+    print_table_header(width);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        node_samples[i].erase(node_samples[i].begin(), node_samples[i].begin() + ctx.opt.warmup);
+        Result r{ "numa", std::format("node{}", nodes[i].id), N, static_cast<unsigned>(nodes[i].cpus.size()),
+                  static_cast<long long>(runs[i].count), generation_ns, std::move(node_samples[i]),
+                  runs[i].checksum.load() };
+        r.metrics.emplace_back("node", nodes[i].id);
+        print_row(r, width);
+        ctx.results.push_back(std::move(r));
     }
 
-    // Benchmark configurations
-    struct BenchmarkConfig {
-        int num_hands;
-        const char* description;
+    Result all{ "numa", "aggregate", N, static_cast<unsigned>(total_cpus), n, generation_ns, std::move(all_samples) };
+    set_checksum(all, sums);
+    print_row(all, width);
+    ctx.results.push_back(std::move(all));
+}
+
+/****************************************************************
+    Service: bursty producers against EvalService
+****************************************************************/
+
+void run_service(Context& ctx)
+{
+    const unsigned hw = ctx.hardware_threads();
+    const unsigned producers = std::max(1u, hw / 2);
+    const unsigned workers = std::max(1u, hw - producers);
+
+    std::println("\n=== Service: {}-card, {:L} requests, {} producers / {} workers ===",
+        ctx.cards, SERVICE_REQUESTS, producers, workers);
+
+    double generation_ns = 0;
+    const HandSet hands = ctx.hands(SERVICE_REQUESTS, generation_ns);
+
+    Result r{ "service", "eval_service", ctx.cards, workers, SERVICE_REQUESTS, generation_ns };
+    std::vector<unsigned long long> sums;
+    ServiceMetrics m;
+    r.samples_ns = measure(ctx.opt, [&] {
+        EvalService service({ .workers = workers });
+        std::atomic<unsigned long long> checksum{ 0 };
+        {
+            std::vector<std::jthread> threads;
+            for (unsigned p = 0; p < producers; ++p) {
+                threads.emplace_back([&, p] {
+                    std::mt19937 gen(p);
+                    std::uniform_int_distribution<int> burst(1, SERVICE_MAX_BURST);
+                    std::vector<std::future<unsigned short>> pending;
+                    unsigned long long sum = 0;
+
+                    const size_t b = hands.size() * p / producers;
+                    const size_t e = hands.size() * (p + 1) / producers;
+                    for (size_t i = b; i < e; ) {
+                        const size_t n = std::min<size_t>(burst(gen), e - i);
+                        for (size_t k = 0; k < n; ++k)
+                            pending.push_back(service.submit(Hand{ hands.hand(i + k), static_cast<size_t>(ctx.cards) }));
+                        for (auto& f : pending)
+                            sum += f.get();
+                        pending.clear();
+                        i += n;
+                    }
+                    checksum += sum;
+                });
+            }
+        }
+        m = service.metrics();
+        sums.push_back(checksum.load());
+    });
+    set_checksum(r, sums);
+    r.metrics = {
+        { "batches", static_cast<double>(m.batches) },
+        { "mean_batch_size", m.mean_batch_size },
+        { "max_queue_depth", static_cast<double>(m.max_queue_depth) },
+        { "p50_us", m.p50_us },
+        { "p99_us", m.p99_us },
+        { "p999_us", m.p999_us },
+        { "max_us", m.max_us },
     };
 
+    const size_t width = name_width({ r.evaluator });
+    print_table_header(width);
+    print_row(r, width);
+    std::println("\n  Batches: {:L} (mean size {:.1f}), max queue depth {}  (last run)",
+        m.batches, m.mean_batch_size, m.max_queue_depth);
+    std::println("  Latency p50 / p99 / p99.9 / max: {:.1f} / {:.1f} / {:.1f} / {:.1f} us",
+        m.p50_us, m.p99_us, m.p999_us, m.max_us);
+    ctx.results.push_back(std::move(r));
+}
 
-    // Single-threaded test
-    std::println("\n=== SINGLE-THREADED {}-Card Test ===", CARD_COUNT);
-    
-    if constexpr (CARD_COUNT == 5) {
-        auto st_hands = generate_test_hands<5>(10'000'000);
-        auto st_start = steady_clock::now();
-        unsigned long long st_total = 0;
-        for (const auto& hand : st_hands) {
-            st_total += evaluate_hand<5>(std::span{ hand });
-        }
-        auto st_end = steady_clock::now();
-        auto st_elapsed = duration_cast<nanoseconds>(st_end - st_start).count() / 1e9;
-        std::println("Single-thread: {:.4f}s, {:.2f}M hands/sec",
-            st_elapsed, 10.0 / st_elapsed);
-        std::println("Checksum: {}", st_total);
-    } else {
-        auto st_hands = generate_test_hands<7>(10'000'000);
-        auto st_start = steady_clock::now();
-        unsigned long long st_total = 0;
-        for (const auto& hand : st_hands) {
-            st_total += evaluate_hand<7>(std::span{ hand });
-        }
-        auto st_end = steady_clock::now();
-        auto st_elapsed = duration_cast<nanoseconds>(st_end - st_start).count() / 1e9;
-        std::println("Single-thread: {:.4f}s, {:.2f}M hands/sec",
-            st_elapsed, 10.0 / st_elapsed);
-        std::println("Checksum: {}", st_total);
-    }
-
-    // Benchmark configurations - adjust based on your needs
-    std::array<BenchmarkConfig, 4> configs;
-    
-    if constexpr (CARD_COUNT == 5) {
-        // 5-card evaluation is faster, use larger test sets
-        configs = { {
-            {50'000'000, "50M hands"},
-            {100'000'000, "100M hands"},
-            {500'000'000, "500M hands"},
-			{1'000'000'000, "1B hands"}
-        } };
+/****************************************************************
+    Distribution: observed categories vs exact odds
+****************************************************************/
+
+void run_distribution(Context& ctx)
+{
+    const long long count = ctx.opt.hands.empty() ? DISTRIBUTION_HANDS : ctx.opt.hands.front();
+    const auto& expected = ctx.cards == 5 ? expected_freq5 : expected_freq7;
+    const double total = static_cast<double>(ctx.cards == 5 ? TOTAL_5CARD_HANDS : TOTAL_7CARD_HANDS);
+
+    std::println("\n=== Distribution: {}-card, {:L} hands ===", ctx.cards, count);
+    double generation_ns = 0;
+    const HandSet hands = ctx.hands(count, generation_ns);
+    PooledArray<unsigned short> values(hands.size());
+
+    for (const Evaluator* e : ctx.evaluators()) {
+        Result r{ "distribution", std::string(e->name), ctx.cards, 1, count, generation_ns };
+        std::vector<unsigned long long> sums;
+        r.samples_ns = measure(ctx.opt, [&] {
+            e->values(hands.data(), hands.size(), values.data());
+            sums.push_back(std::accumulate(values.begin(), values.end(), 0ULL));
+        });
+        set_checksum(r, sums);
+
+        std::array<unsigned long long, 10> freq{};
+        for (unsigned short v : values)
+            ++freq[hand_rank(v)];
+
+        std::println("\n  {}", e->name);
+        std::println("  {:>15s} {:>12s} {:>9s} {:>9s}", "Category", "Hands", "Observed", "Expected");
+        double max_error = 0;
+        for (int i = 1; i <= 9; ++i) {
+            const double observed = freq[i] * 100.0 / count;
+            const double exact = expected[i] * 100.0 / total;
+            max_error = std::max(max_error, std::abs(observed - exact));
+            std::println("  {:>15s} {:12d} {:8.4f}% {:8.4f}%", value_str[i], freq[i], observed, exact);
+            r.metrics.emplace_back(value_str[i], static_cast<double>(freq[i]));
+        }
+        std::println("  max |observed - expected| = {:.4f} percentage points", max_error);
+        r.metrics.emplace_back("max_error_pct", max_error);
+        ctx.results.push_back(std::move(r));
+    }
+}
+
+/****************************************************************
+    Latency: per-call TSC timing, split by hand category
+****************************************************************/
+
+// Written after every timed call so the evaluation cannot be moved past tsc_stop
+volatile unsigned short latency_sink;
+
+// Time every group of `group` hands; ticks[c] gets the corrected cost of
+// group c and values its results. Runs on one (optionally pinned) thread.
+void time_calls(const Evaluator& e, const HandSet& hands, int group, uint64_t overhead,
+                std::span<uint64_t> ticks, std::span<unsigned short> values)
+{
+    auto corrected = [overhead](uint64_t t0, uint64_t t1) { return t1 - t0 > overhead ? t1 - t0 - overhead : 0; };
+
+    if (group == 1 && e.single) {
+        for (size_t c = 0; c < ticks.size(); ++c) {
+            const int* hand = hands.hand(c);
+            const uint64_t t0 = tsc_start();
+            latency_sink = values[c] = e.single(hand);
+            const uint64_t t1 = tsc_stop();
+            ticks[c] = corrected(t0, t1);
+        }
     } else {
-        // 7-card evaluation is slower, use smaller test sets
-        configs = { {
-            {5'000'000, "5M hands"},
-            {10'000'000, "10M hands"},
-            {50'000'000, "50M hands"},
-			{100'000'000, "100M hands"}
-        } };
-    }
-
-    for (const auto& config : configs) {
-        std::println("\n--- {} ---", config.description);
-        std::println("Generating {} random {}-card hands...", config.num_hands, CARD_COUNT);
-
-        unsigned long long total = 0;
-        auto start = steady_clock::now();
-        auto end = steady_clock::now();
-
-        if constexpr (CARD_COUNT == 5) {
-            auto test_hands = generate_test_hands<5>(config.num_hands);
-            std::println("Evaluating...");
-            
-            start = steady_clock::now();
-            total = std::transform_reduce(
-                std::execution::par,
-                test_hands.begin(),
-                test_hands.end(),
-                0ULL,
-                std::plus<unsigned long long>{},
-                [](const auto& hand) -> unsigned long long {
-                    return evaluate_hand<5>(std::span{ hand });
+        for (size_t c = 0; c < ticks.size(); ++c) {
+            const size_t first = c * group;
+            const uint64_t t0 = tsc_start();
+            e.values(hands.hand(first), group, values.data() + first);
+            latency_sink = values[first + group - 1];
+            const uint64_t t1 = tsc_stop();
+            ticks[c] = corrected(t0, t1);
+        }
+    }
+}
+
+void run_latency(Context& ctx)
+{
+    const long long count = ctx.opt.hands.empty() ? LATENCY_HANDS : ctx.opt.hands.front();
+    const int group = ctx.opt.group;
+    const size_t calls = static_cast<size_t>(count) / group;
+    if (calls == 0) throw std::invalid_argument("--group is larger than --hands");
+
+    double generation_ns = 0;
+    const HandSet hands = ctx.hands(count, generation_ns);
+    PooledArray<uint64_t> ticks(calls);
+    PooledArray<unsigned short> values(hands.size());
+
+    // Calibrate on the thread that will do the timing
+    ThreadPool& pool = ctx.pools.get(1);
+    uint64_t overhead = 0;
+    double ticks_per_ns = 1;
+    pool.parallel_for(1, [&](size_t, size_t, unsigned) {
+        overhead = tsc_overhead();
+        ticks_per_ns = tsc_ticks_per_ns();
+    });
+
+    std::println("\n=== Latency: {}-card, {:L} hands, {} per timed call, {} at {:.3f} GHz, {} ticks overhead subtracted ===",
+        ctx.cards, calls * group, group, HAS_TSC ? "TSC" : "steady_clock", ticks_per_ns, overhead);
+
+    // Histograms in ticks per group: [0] every call, [1..9] by category when group == 1
+    const double ns_scale = ticks_per_ns * group;
+    for (const Evaluator* e : ctx.evaluators()) {
+        std::vector<LatencyHistogram> hist(10);
+        pool.parallel_for(1, [&](size_t, size_t, unsigned) {
+            for (int rep = -ctx.opt.warmup; rep < ctx.opt.repetitions; ++rep) {
+                time_calls(*e, hands, group, overhead, ticks.span(), values.span());
+                if (rep < 0) continue;
+                for (size_t c = 0; c < calls; ++c) {
+                    hist[0].record(ticks[c]);
+                    if (group == 1) hist[hand_rank(values[c])].record(ticks[c]);
+                }
+            }
+        });
+
+        Result r{ "latency", std::string(e->name), ctx.cards, 1, static_cast<long long>(calls * group), generation_ns };
+        r.checksum = std::accumulate(values.begin(), values.begin() + calls * group, 0ULL);
+
+        std::println("\n  {} (ns per hand)", e->name);
+        std::println("  {:>15s} {:>12s} {:>8s} {:>8s} {:>8s} {:>8s} {:>8s} {:>9s} {:>8s}",
+            "Category", "Calls", "min", "p50", "p90", "p99", "p99.9", "max", "mean");
+        for (int i = 0; i <= 9; ++i) {
+            const LatencyHistogram& h = hist[i];
+            if (h.count() == 0) continue;
+            auto ns = [&](uint64_t t) { return t / ns_scale; };
+            const std::string_view label = i ? value_str[i] : "All";
+            std::println("  {:>15s} {:12L} {:8.1f} {:8.1f} {:8.1f} {:8.1f} {:8.1f} {:9.1f} {:8.1f}",
+                label, h.count(), ns(h.min()), ns(h.percentile(0.5)), ns(h.percentile(0.9)),
+                ns(h.percentile(0.99)), ns(h.percentile(0.999)), ns(h.max()), h.mean() / ns_scale);
+
+            const std::string prefix = i ? std::string(label) + " " : "";
+            r.metrics.emplace_back(prefix + "calls", static_cast<double>(h.count()));
+            r.metrics.emplace_back(prefix + "p50_ns", ns(h.percentile(0.5)));
+            r.metrics.emplace_back(prefix + "p99_ns", ns(h.percentile(0.99)));
+            r.metrics.emplace_back(prefix + "p999_ns", ns(h.percentile(0.999)));
+            r.metrics.emplace_back(prefix + "max_ns", ns(h.max()));
+            r.metrics.emplace_back(prefix + "mean_ns", h.mean() / ns_scale);
+        }
+
+        if (!ctx.opt.hgrm.empty()) {
+            const std::string path = std::format("{}-{}-{}.hgrm", ctx.opt.hgrm, e->name, ctx.cards);
+            FILE* f = std::fopen(path.c_str(), "wb");
+            if (!f) throw std::runtime_error("cannot open '" + path + "' for writing");
+            write_percentiles(f, hist[0], ns_scale);
+            std::fclose(f);
+            std::println("  Histogram written to {}", path);
+        }
+        ctx.results.push_back(std::move(r));
+    }
+}
+
+/****************************************************************
+    Paths: which eval_5cards / eval_7hand paths the hands take
+****************************************************************/
+
+template<int N>
+unsigned long long evaluate_counted(ThreadPool& pool, const HandSet& hands)
+{
+    struct alignas(64) Partial { unsigned long long sum = 0; };
+    std::vector<Partial> partial(pool.size());
+    pool.parallel_for(hands.size(), [&](size_t b, size_t e, unsigned w) {
+        unsigned long long sum = 0;
+        for (size_t i = b; i < e; ++i) {
+            const int* h = hands.hand(i);
+            if constexpr (N == 5)
+                sum += eval_5cards<EvalCounters>(h[0], h[1], h[2], h[3], h[4]);
+            else
+                sum += eval_7hand<EvalCounters>(Hand{ h, 7 });
+        }
+        partial[w].sum += sum;
+    });
+    unsigned long long sum = 0;
+    for (const auto& p : partial)
+        sum += p.sum;
+    return sum;
+}
+
+void run_paths(Context& ctx)
+{
+    const long long count = ctx.hand_counts().front();
+    std::println("\n=== Paths: {}-card, {:L} hands ===", ctx.cards, count);
+    double generation_ns = 0;
+    const HandSet hands = ctx.hands(count, generation_ns);
+    auto evaluate = ctx.cards == 5 ? &evaluate_counted<5> : &evaluate_counted<7>;
+
+    const size_t width = name_width({ "kev+counters" });
+    print_table_header(width);
+    for (unsigned threads : ctx.opt.threads) {
+        ThreadPool& pool = ctx.pools.get(threads);
+        Result r{ "paths", "kev+counters", ctx.cards, threads, count, generation_ns };
+        std::vector<unsigned long long> sums;
+        r.samples_ns = measure(ctx.opt, [&] { sums.push_back(evaluate(pool, hands)); });
+        set_checksum(r, sums);
+        print_row(r, width);
+        ctx.results.push_back(std::move(r));
+    }
+
+    // One more pass with fresh counters, so the counts cover each hand once
+    EvalCounters::reset();
+    (void)evaluate(ctx.pools.get(ctx.opt.threads.back()), hands);
+    const EvalCounterData d = EvalCounters::snapshot();
+    std::println("");
+    print_counters(stdout, d);
+
+    Result& r = ctx.results.back();
+    const double calls = static_cast<double>(d.calls5());
+    r.metrics = {
+        { "unique5_share", d.unique5 / calls },
+        { "flush_share", d.flush / calls },
+        { "hash_share", d.hash / calls },
+    };
+    if (d.hands7) {
+        r.metrics.emplace_back("early_exit7_share", static_cast<double>(d.early_exit7) / d.hands7);
+        r.metrics.emplace_back("subsets_per_7hand", static_cast<double>(d.subsets7) / d.hands7);
+    }
+}
+
+/****************************************************************
+    Working set: the same hands from L1-sized to DRAM-sized inputs
+****************************************************************/
+
+struct CacheLevel {
+    int level = 0;
+    size_t bytes = 0;
+};
+
+// Data and unified caches of CPU 0, from sysfs; empty where that is unavailable
+std::vector<CacheLevel> cache_levels()
+{
+    std::vector<CacheLevel> out;
+    for (int i = 0; ; ++i) {
+        const std::string dir = std::format("/sys/devices/system/cpu/cpu0/cache/index{}/", i);
+        std::ifstream level(dir + "level"), type(dir + "type"), size(dir + "size");
+        CacheLevel c;
+        std::string kind, bytes;
+        if (!(level >> c.level) || !(type >> kind) || !(size >> bytes)) break;
+        if (kind == "Instruction") continue;
+        c.bytes = std::stoull(bytes) * (bytes.back() == 'K' ? 1024 : bytes.back() == 'M' ? 1024 * 1024 : 1);
+        out.push_back(c);
+    }
+    return out;
+}
+
+std::string format_bytes(double bytes)
+{
+    if (bytes >= 1 << 30) return std::format("{:.0f} GB", bytes / (1 << 30));
+    if (bytes >= 1 << 20) return std::format("{:.0f} MB", bytes / (1 << 20));
+    return std::format("{:.0f} KB", bytes / (1 << 10));
+}
+
+// Smallest cache that holds `bytes`, or DRAM
+std::string fits_in(const std::vector<CacheLevel>& caches, size_t bytes)
+{
+    for (const auto& c : caches)
+        if (bytes <= c.bytes) return std::format("L{}", c.level);
+    return caches.empty() ? "" : "DRAM";
+}
+
+// Evaluate `total` hands cycling through the first ws_hands of the set
+unsigned long long evaluate_cycled(ThreadPool& pool, const Evaluator& e, const HandSet& hands, size_t ws_hands, size_t total)
+{
+    struct alignas(64) Partial { unsigned long long sum = 0; };
+    std::vector<Partial> partial(pool.size());
+    pool.parallel_for(total, [&](size_t b, size_t end, unsigned w) {
+        unsigned long long sum = 0;
+        while (b < end) {
+            const size_t i = b % ws_hands;
+            const size_t n = std::min(end - b, ws_hands - i);
+            sum += e.checksum(hands.hand(i), n);
+            b += n;
+        }
+        partial[w].sum += sum;
+    });
+    unsigned long long sum = 0;
+    for (const auto& p : partial)
+        sum += p.sum;
+    return sum;
+}
+
+// Deal a hand from a counter-based generator, two cards per 64-bit word,
+// with no tables and no memory input. A repeated card moves to the next
+// free one, a slight bias that does not matter for timing.
+inline void deal_regenerated(int* hand, int cards, uint64_t& state, const Deck& deck) noexcept
+{
+    uint64_t used = 0, r = 0;
+    for (int j = 0; j < cards; ++j, r >>= 32) {
+        if (j % 2 == 0) {
+            r = (state += 0x9E3779B97F4A7C15ULL);
+            r = (r ^ (r >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            r = (r ^ (r >> 27)) * 0x94D049BB133111EBULL;
+        }
+        unsigned c = static_cast<unsigned>(((r & 0xFFFFFFFF) * 52) >> 32);
+        while (used >> c & 1)
+            c = c == 51 ? 0 : c + 1;
+        used |= uint64_t{ 1 } << c;
+        hand[j] = deck[c];
+    }
+}
+
+// Evaluate `total` hands dealt into an L1-resident buffer per call; with a
+// null evaluator only the dealing is timed. Hands are dealt in fixed
+// GENERATION_BLOCK blocks, each seeded by its index, so every run deals the
+// same hands however the pool splits the work.
+unsigned long long evaluate_regenerated(ThreadPool& pool, const Evaluator* e, int cards, size_t total, uint64_t seed)
+{
+    const Deck deck = init_deck();
+    const size_t blocks = (total + GENERATION_BLOCK - 1) / GENERATION_BLOCK;
+    struct alignas(64) Partial { unsigned long long sum = 0; };
+    std::vector<Partial> partial(pool.size());
+    pool.parallel_for(blocks, [&](size_t b, size_t end, unsigned w) {
+        std::array<int, REGENERATED_HANDS * 7> buffer;
+        unsigned long long sum = 0;
+        for (size_t block = b; block < end; ++block) {
+            uint64_t state = block_seed(seed, block);
+            const size_t first = block * GENERATION_BLOCK;
+            const size_t last = std::min(total, first + GENERATION_BLOCK);
+            for (size_t i = first; i < last; i += REGENERATED_HANDS) {
+                const size_t n = std::min(last - i, REGENERATED_HANDS);
+                for (size_t k = 0; k < n; ++k)
+                    deal_regenerated(buffer.data() + k * cards, cards, state, deck);
+                if (e)
+                    sum += e->checksum(buffer.data(), n);
+                else
+                    sum += static_cast<unsigned>(buffer[0] ^ buffer[(n - 1) * cards]);
+            }
+        }
+        partial[w].sum += sum;
+    });
+    unsigned long long sum = 0;
+    for (const auto& p : partial)
+        sum += p.sum;
+    return sum;
+}
+
+void run_working_set(Context& ctx)
+{
+    const size_t hand_bytes = ctx.cards * sizeof(int);
+    const size_t total = static_cast<size_t>(ctx.hand_counts().front());
+    const size_t max_hands = std::max<size_t>(1, static_cast<size_t>(ctx.opt.ws_max) / hand_bytes);
+    const auto caches = cache_levels();
+
+    std::println("\n=== Working set: {}-card, {:L} hands per run, {} .. {} of input ===",
+        ctx.cards, total, format_bytes(static_cast<double>(ctx.opt.ws_min)), format_bytes(static_cast<double>(ctx.opt.ws_max)));
+    std::string layout;
+    for (const auto& c : caches)
+        layout += std::format("  L{} {}", c.level, format_bytes(static_cast<double>(c.bytes)));
+    std::println("  CPU 0 caches:{}", layout.empty() ? " unknown" : layout);
+
+    double generation_ns = 0;
+    const HandSet hands = ctx.hands(static_cast<long long>(max_hands), generation_ns);
+
+    // Every row is scaled against the fastest row of its evaluator and thread count
+    auto print_curve = [](const std::vector<std::pair<std::string, Result>>& rows) {
+        double best = 0;
+        for (const auto& [label, r] : rows)
+            best = std::max(best, r.mhands_per_sec());
+        for (const auto& [label, r] : rows) {
+            const Summary s = r.summary();
+            const int bar = best > 0 ? static_cast<int>(r.mhands_per_sec() / best * 40 + 0.5) : 0;
+            std::println("  {:>16s} {:>10.2f} {:>9.3f} {:>6.2f}%  {}{}", label, r.mhands_per_sec(), r.ns_per_hand(),
+                s.median > 0 ? s.mad / s.median * 100 : 0.0, std::string(bar, '#'),
+                r.checksum_consistent ? "" : "  INCONSISTENT");
+        }
+    };
+
+    for (const Evaluator* e : ctx.evaluators()) {
+        for (unsigned threads : ctx.opt.threads) {
+            ThreadPool& pool = ctx.pools.get(threads);
+            std::println("\n  {}, {} thread(s)", e->name, threads);
+            std::println("  {:>16s} {:>10s} {:>9s} {:>7s}", "Working set", "M hands/s", "ns/hand", "MAD");
+            std::vector<std::pair<std::string, Result>> rows;
+
+            for (size_t bytes = static_cast<size_t>(ctx.opt.ws_min); ; bytes *= 2) {
+                const size_t ws_hands = std::clamp<size_t>(bytes / hand_bytes, 1, max_hands);
+                const size_t ws_bytes = ws_hands * hand_bytes;
+                Result r{ "workingset", std::string(e->name), ctx.cards, threads, static_cast<long long>(total), generation_ns };
+                std::vector<unsigned long long> sums;
+                r.samples_ns = measure(ctx.opt, [&] { sums.push_back(evaluate_cycled(pool, *e, hands, ws_hands, total)); });
+                set_checksum(r, sums);
+                r.metrics.emplace_back("working_set_bytes", static_cast<double>(ws_bytes));
+                const std::string where = fits_in(caches, ws_bytes);
+                rows.emplace_back(format_bytes(static_cast<double>(ws_bytes)) + (where.empty() ? "" : " " + where), r);
+                ctx.results.push_back(std::move(r));
+                if (ws_hands == max_hands) break;
+            }
+
+            Result regen{ "workingset", std::string(e->name), ctx.cards, threads, static_cast<long long>(total) };
+            std::vector<unsigned long long> sums;
+            regen.samples_ns = measure(ctx.opt, [&] { sums.push_back(evaluate_regenerated(pool, e, ctx.cards, total, ctx.opt.seed)); });
+            set_checksum(regen, sums);
+            regen.metrics.emplace_back("working_set_bytes", 0);
+            rows.emplace_back("regenerated", regen);
+            ctx.results.push_back(std::move(regen));
+
+            Result deal{ "workingset", "(dealing only)", ctx.cards, threads, static_cast<long long>(total) };
+            sums.clear();
+            deal.samples_ns = measure(ctx.opt, [&] { sums.push_back(evaluate_regenerated(pool, nullptr, ctx.cards, total, ctx.opt.seed)); });
+            set_checksum(deal, sums);
+            deal.metrics.emplace_back("working_set_bytes", 0);
+            rows.emplace_back("dealing only", deal);
+            ctx.results.push_back(std::move(deal));
+
+            print_curve(rows);
+        }
+    }
+}
+
+/****************************************************************
+    Prefetch: pipelined evaluators across lookahead distances
+****************************************************************/
+
+unsigned long long evaluate_lookahead(ThreadPool& pool, const Evaluator& e, const HandSet& hands, int lookahead)
+{
+    struct alignas(64) Partial { unsigned long long sum = 0; };
+    std::vector<Partial> partial(pool.size());
+    pool.parallel_for(hands.size(), [&](size_t b, size_t end, unsigned w) {
+        partial[w].sum += e.lookahead(hands.hand(b), end - b, lookahead);
+    });
+    unsigned long long sum = 0;
+    for (const auto& p : partial)
+        sum += p.sum;
+    return sum;
+}
+
+void run_prefetch(Context& ctx)
+{
+    std::vector<const Evaluator*> pipelined;
+    for (const Evaluator* e : ctx.evaluators())
+        if (e->lookahead) pipelined.push_back(e);
+    if (pipelined.empty()) {
+        std::println("\n=== Prefetch: no pipelined {}-card evaluator selected ===", ctx.cards);
+        return;
+    }
+
+    for (long long count : ctx.hand_counts()) {
+        std::println("\n=== Prefetch: {}-card, {:L} hands ===", ctx.cards, count);
+        double generation_ns = 0;
+        const HandSet hands = ctx.hands(count, generation_ns);
+
+        for (const Evaluator* e : pipelined) {
+            for (unsigned threads : ctx.opt.threads) {
+                ThreadPool& pool = ctx.pools.get(threads);
+                std::println("\n  {}, {} thread(s)", e->name, threads);
+                std::vector<std::string> names;
+                for (int lookahead : ctx.opt.lookaheads)
+                    names.push_back(std::format("{}@{}", e->name, lookahead));
+                const size_t width = name_width(names);
+                print_table_header(width);
+                double scalar_ns = 0;
+                for (int lookahead : ctx.opt.lookaheads) {
+                    Result r{ "prefetch", std::format("{}@{}", e->name, lookahead), ctx.cards, threads, count, generation_ns };
+                    std::vector<unsigned long long> sums;
+                    r.samples_ns = measure(ctx.opt, [&] { sums.push_back(evaluate_lookahead(pool, *e, hands, lookahead)); });
+                    set_checksum(r, sums);
+                    r.metrics.emplace_back("lookahead", lookahead);
+                    if (lookahead == 0) scalar_ns = r.ns_per_hand();
+                    if (scalar_ns > 0) r.metrics.emplace_back("speedup_vs_scalar", scalar_ns / r.ns_per_hand());
+                    print_row(r, width);
+                    count_events(ctx, r, [&] { evaluate_lookahead(pool, *e, hands, lookahead); });
+                    ctx.results.push_back(std::move(r));
                 }
-            );
-            end = steady_clock::now();
-        } else {
-            auto test_hands = generate_test_hands<7>(config.num_hands);
-            std::println("Evaluating...");
-            
-            start = steady_clock::now();
-            total = std::transform_reduce(
-                std::execution::par,
-                test_hands.begin(),
-                test_hands.end(),
-                0ULL,
-                std::plus<unsigned long long>{},
-                [](const auto& hand) -> unsigned long long {
-                    return evaluate_hand<7>(std::span{ hand });
+            }
+        }
+    }
+}
+
+/****************************************************************
+    Bitslice: bit-sliced evaluation phase by phase vs Cactus Kev
+****************************************************************/
+
+enum class BitslicePhase { Transpose, Logic, Values };
+
+// Run the bit-sliced evaluator over every hand up to and including `last`.
+// The block belongs to the caller so the partial phases are not optimised away.
+template<int Words>
+unsigned long long bitslice_phases(BitSlicedBlock<Words>& block, const HandSet& hands, BitslicePhase last)
+{
+    constexpr size_t LANES = BitSlicedBlock<Words>::LANES;
+    std::array<unsigned short, LANES> values;
+    unsigned long long sum = 0;
+    for (size_t b = 0; b < hands.size(); b += LANES) {
+        const size_t n = std::min(hands.size() - b, LANES);
+        block.load(hands.hand(b), n, hands.cards);
+        if (last == BitslicePhase::Transpose) continue;
+        block.evaluate();
+        if (last == BitslicePhase::Logic) continue;
+        block.store(values.data(), n);
+        for (size_t i = 0; i < n; ++i)
+            sum += values[i];
+    }
+    return sum;
+}
+
+template<int Words>
+void run_bitslice_width(Context& ctx, const HandSet& hands, double generation_ns, std::string_view name, size_t width)
+{
+    auto block = std::make_unique<BitSlicedBlock<Words>>();
+    constexpr std::array<std::pair<BitslicePhase, std::string_view>, 3> phases = { {
+        { BitslicePhase::Transpose, "transpose" },
+        { BitslicePhase::Logic, "+logic" },
+        { BitslicePhase::Values, "+values" },
+    } };
+
+    std::array<double, 3> ns{};
+    for (size_t p = 0; p < phases.size(); ++p) {
+        Result r{ "bitslice", std::format("{}:{}", name, phases[p].second), ctx.cards, 1,
+                  static_cast<long long>(hands.size()), generation_ns };
+        std::vector<unsigned long long> sums;
+        r.samples_ns = measure(ctx.opt, [&] { sums.push_back(bitslice_phases(*block, hands, phases[p].first)); });
+        set_checksum(r, sums);
+        print_row(r, width);
+        ns[p] = r.ns_per_hand();
+        ctx.results.push_back(std::move(r));
+    }
+    std::println("  {} per hand: transpose {:.3f} ns, logic {:.3f} ns, values {:.3f} ns",
+        name, ns[0], ns[1] - ns[0], ns[2] - ns[1]);
+}
+
+void run_bitslice(Context& ctx)
+{
+    const long long count = ctx.hand_counts().front();
+    std::println("\n=== Bitslice: {}-card, {:L} hands, 1 thread ===", ctx.cards, count);
+    double generation_ns = 0;
+    const HandSet hands = ctx.hands(count, generation_ns);
+    ThreadPool& pool = ctx.pools.get(1);
+
+    // One table for the Kev rows and both widths' phase rows
+    std::vector<std::string> names;
+    for (const Evaluator* e : select_evaluators(ctx.cards, { "kev" }))
+        names.emplace_back(e->name);
+    for (std::string_view phase : { "transpose", "+logic", "+values" })
+        names.push_back(std::format("bitslice256:{}", phase));
+    const size_t width = name_width(names);
+    print_table_header(width);
+    for (const Evaluator* e : select_evaluators(ctx.cards, { "kev" })) {
+        Result r{ "bitslice", std::string(e->name), ctx.cards, 1, count, generation_ns };
+        std::vector<unsigned long long> sums;
+        r.samples_ns = measure(ctx.opt, [&] { sums.push_back(evaluate_all(pool, *e, hands)); });
+        set_checksum(r, sums);
+        print_row(r, width);
+        ctx.results.push_back(std::move(r));
+    }
+    run_bitslice_width<1>(ctx, hands, generation_ns, "bitslice", width);
+    run_bitslice_width<4>(ctx, hands, generation_ns, "bitslice256", width);
+}
+
+/****************************************************************
+    Branches: branchy vs branch-free on unordered and ordered hands
+****************************************************************/
+
+// The same hands, stably grouped by category so eval_5cards' branches
+// (and eval_7hand's subset pattern) repeat from one hand to the next
+HandSet grouped_by_category(const HandSet& hands)
+{
+    std::vector<std::pair<int, size_t>> order(hands.size());
+    for (size_t i = 0; i < hands.size(); ++i) {
+        const int* h = hands.hand(i);
+        const unsigned short v = hands.cards == 5 ? eval_5cards(h[0], h[1], h[2], h[3], h[4]) : eval_7hand(Hand{ h, 7 });
+        order[i] = { hand_rank(v), i };
+    }
+    std::stable_sort(order.begin(), order.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    const HugePages pages = hands.buffer().backing() == PageBacking::Small ? HugePages::Off : HugePages::On;
+    HandSet out(hands.cards, hands.size(), pages);
+    for (size_t i = 0; i < order.size(); ++i)
+        std::copy_n(hands.hand(order[i].second), hands.cards, out.hand(i));
+    return out;
+}
+
+void run_branches(Context& ctx)
+{
+    const long long count = ctx.hand_counts().front();
+    std::println("\n=== Branches: {}-card, {:L} hands ===", ctx.cards, count);
+    double generation_ns = 0;
+    const HandSet hands = ctx.hands(count, generation_ns);
+    const HandSet grouped = grouped_by_category(hands);
+
+    const std::array<std::pair<std::string_view, const HandSet*>, 2> datasets = { {
+        { ctx.input ? "input" : "random", &hands },
+        { "grouped", &grouped },
+    } };
+    for (const auto& [label, set] : datasets) {
+        std::println("\n  {} hands", label);
+        const size_t width = name_width(evaluator_names(ctx, std::format("/{}", label)));
+        print_table_header(width);
+        for (const Evaluator* e : ctx.evaluators()) {
+            for (unsigned threads : ctx.opt.threads) {
+                ThreadPool& pool = ctx.pools.get(threads);
+                Result r{ "branches", std::format("{}/{}", e->name, label), ctx.cards, threads, count, generation_ns };
+                std::vector<unsigned long long> sums;
+                r.samples_ns = measure(ctx.opt, [&] { sums.push_back(evaluate_all(pool, *e, *set)); });
+                set_checksum(r, sums);
+                print_row(r, width);
+                count_events(ctx, r, [&] { evaluate_all(pool, *e, *set); });
+                ctx.results.push_back(std::move(r));
+            }
+        }
+    }
+}
+
+/****************************************************************
+    Reorder: where bucketing hands by table region pays off
+****************************************************************/
+
+// A uint16_t table of any size indexed by a hash of the hand, standing in
+// for a large direct-lookup evaluator. The high 32 bits of the hash pick
+// the entry, so the bucket, their top bits, follows table order.
+class SyntheticTable {
+public:
+    explicit SyntheticTable(size_t bytes)
+        : values_(std::max<size_t>(1, bytes / sizeof(uint16_t))),
+          bucket_bits_(std::clamp(static_cast<int>(std::bit_width(bytes / REORDER_REGION_BYTES)) - 1, 0, 16))
+    {
+        for (size_t i = 0; i < values_.size(); ++i)
+            values_[i] = static_cast<uint16_t>(i * 2654435761u >> 16);
+    }
+
+    [[nodiscard]] size_t bytes() const noexcept { return values_.size() * sizeof(uint16_t); }
+    [[nodiscard]] int bucket_bits() const noexcept { return bucket_bits_; }
+
+    [[nodiscard]] static uint32_t hash(const int* h, int cards) noexcept
+    {
+        // Independent products, then one mixing step: short enough that
+        // hashing a hand twice (bucket, then lookup) stays cheap
+        uint64_t x = 0;
+        for (int k = 0; k < cards; ++k)
+            x += static_cast<uint32_t>(h[k]) * 0x9E3779B97F4A7C15ULL;
+        x ^= x >> 29;
+        return static_cast<uint32_t>((x * 0xBF58476D1CE4E5B9ULL) >> 32);
+    }
+
+    [[nodiscard]] unsigned short lookup(const int* h, int cards) const noexcept
+    {
+        return values_[static_cast<size_t>((uint64_t{ hash(h, cards) } * values_.size()) >> 32)];
+    }
+
+    [[nodiscard]] uint32_t bucket(const int* h, int cards) const noexcept
+    {
+        return bucket_bits_ ? hash(h, cards) >> (32 - bucket_bits_) : 0;
+    }
+
+private:
+    std::vector<uint16_t> values_;
+    int bucket_bits_;
+};
+
+// Score every hand in batches of REORDER_BATCH_HANDS, directly or through
+// LocalityReorder. The checksum folds the values in input order, so a
+// reordered run only matches a direct one if every value went back to the
+// right place.
+template<typename Lookup, typename Bucket>
+unsigned long long evaluate_batches(ThreadPool& pool, const HandSet& hands, bool reorder, int bucket_bits,
+                                    Lookup&& lookup, Bucket&& bucket)
+{
+    struct alignas(64) Worker {
+        unsigned long long sum = 0;
+        LocalityReorder reorder;
+        std::vector<unsigned short> values;
+    };
+    std::vector<Worker> workers(pool.size());
+    const size_t batches = (hands.size() + REORDER_BATCH_HANDS - 1) / REORDER_BATCH_HANDS;
+    const int cards = hands.cards;
+
+    pool.parallel_for(batches, [&](size_t b, size_t e, unsigned w) {
+        Worker& wk = workers[w];
+        auto score = [&](const int* batch, size_t n, unsigned short* out) {
+            for (size_t i = 0; i < n; ++i)
+                out[i] = lookup(batch + i * cards);
+        };
+        for (size_t k = b; k < e; ++k) {
+            const size_t first = k * REORDER_BATCH_HANDS;
+            const size_t n = std::min(REORDER_BATCH_HANDS, hands.size() - first);
+            wk.values.resize(n);
+            if (reorder)
+                wk.reorder.evaluate(hands.hand(first), n, cards, bucket_bits, bucket, score, wk.values.data());
+            else
+                score(hands.hand(first), n, wk.values.data());
+            unsigned long long fold = 0;
+            for (unsigned short v : wk.values)
+                fold = fold * 31 + v;
+            wk.sum += fold;
+        }
+    });
+    unsigned long long sum = 0;
+    for (const auto& wk : workers)
+        sum += wk.sum;
+    return sum;
+}
+
+void run_reorder(Context& ctx)
+{
+    const long long count = ctx.hand_counts().front();
+    std::println("\n=== Reorder: {}-card, {:L} hands in batches of {:L} ===", ctx.cards, count, REORDER_BATCH_HANDS);
+    double generation_ns = 0;
+    const HandSet hands = ctx.hands(count, generation_ns);
+    const auto caches = cache_levels();
+
+    for (unsigned threads : ctx.opt.threads) {
+        ThreadPool& pool = ctx.pools.get(threads);
+        std::println("\n  {} thread(s)", threads);
+        std::println("  {:>16s} {:>8s} {:>10s} {:>10s} {:>8s}", "Table", "Buckets", "direct ns", "reorder ns", "Speedup");
+
+        // One direct and one reordered row; the result pair carries the comparison
+        auto compare = [&](const std::string& name, const std::string& label, size_t table_bytes, int bits,
+                           auto&& lookup, auto&& bucket) {
+            std::array<Result, 2> rows;
+            for (int reorder = 0; reorder < 2; ++reorder) {
+                Result r{ "reorder", std::format("{}/{}", name, reorder ? "reordered" : "direct"), ctx.cards, threads, count, generation_ns };
+                std::vector<unsigned long long> sums;
+                r.samples_ns = measure(ctx.opt, [&] {
+                    sums.push_back(evaluate_batches(pool, hands, reorder != 0, bits, lookup, bucket));
+                });
+                set_checksum(r, sums);
+                r.metrics.emplace_back("table_bytes", static_cast<double>(table_bytes));
+                r.metrics.emplace_back("bucket_bits", bits);
+                rows[reorder] = std::move(r);
+            }
+            const double speedup = rows[0].ns_per_hand() / rows[1].ns_per_hand();
+            rows[1].metrics.emplace_back("speedup", speedup);
+            if (rows[0].checksum != rows[1].checksum)
+                rows[1].checksum_consistent = false;
+            std::println("  {:>16s} {:>8d} {:>10.3f} {:>10.3f} {:>7.2f}x{}", label, 1 << bits,
+                rows[0].ns_per_hand(), rows[1].ns_per_hand(), speedup,
+                rows[1].checksum_consistent ? "" : "  INCONSISTENT");
+            for (auto& r : rows)
+                ctx.results.push_back(std::move(r));
+        };
+
+        for (size_t bytes : REORDER_TABLE_BYTES) {
+            const SyntheticTable table(bytes);
+            const std::string where = fits_in(caches, table.bytes());
+            compare("synthetic", format_bytes(static_cast<double>(table.bytes())) + (where.empty() ? "" : " " + where),
+                table.bytes(), table.bucket_bits(),
+                [&](const int* h) { return table.lookup(h, ctx.cards); },
+                [&](const int* h) { return table.bucket(h, ctx.cards); });
+        }
+
+        if (ctx.cards == 5) {
+            constexpr int bits = 8;
+            compare("kev", "kev tables", sizeof(unique5) + sizeof(flushes) + sizeof(hash_adjust) + sizeof(hash_values), bits,
+                [](const int* h) { return eval_5cards(h[0], h[1], h[2], h[3], h[4]); },
+                [](const int* h) { return kev5_table_key(h) >> (KEV5_KEY_BITS - bits); });
+        }
+    }
+}
+
+/****************************************************************
+    Table7: precomputed 7-card table vs computed evaluation
+****************************************************************/
+
+// Rank and look up every hand, `lookahead` hands apart; 0 is one at a time
+unsigned long long evaluate_table7(ThreadPool& pool, const Table7& table, const HandSet& hands, int lookahead)
+{
+    struct alignas(64) Partial { unsigned long long sum = 0; };
+    std::vector<Partial> partial(pool.size());
+    pool.parallel_for(hands.size(), [&](size_t b, size_t end, unsigned w) {
+        unsigned long long sum = 0;
+        table.eval_pipelined(hands.hand(b), end - b, lookahead, [&](size_t, unsigned short v) { sum += v; });
+        partial[w].sum += sum;
+    });
+    unsigned long long sum = 0;
+    for (const auto& p : partial)
+        sum += p.sum;
+    return sum;
+}
+
+// The colex rank alone, to separate its cost from the table load
+unsigned long long rank_table7(ThreadPool& pool, const HandSet& hands)
+{
+    struct alignas(64) Partial { unsigned long long sum = 0; };
+    std::vector<Partial> partial(pool.size());
+    pool.parallel_for(hands.size(), [&](size_t b, size_t end, unsigned w) {
+        unsigned long long sum = 0;
+        for (size_t i = b; i < end; ++i)
+            sum += colex_rank7(hands.hand(i));
+        partial[w].sum += sum;
+    });
+    unsigned long long sum = 0;
+    for (const auto& p : partial)
+        sum += p.sum;
+    return sum;
+}
+
+void run_table7(Context& ctx)
+{
+    if (ctx.cards != 7) {
+        std::println("\n=== Table7: 7-card only, skipped for {}-card hands ===", ctx.cards);
+        return;
+    }
+
+    ThreadPool& build_pool = ctx.pools.get(ctx.hardware_threads());
+    const auto start = steady_clock::now();
+    const Table7 table = ctx.opt.table7.empty() ? Table7::build(build_pool) : Table7::open(ctx.opt.table7);
+    const double load_sec = duration_cast<nanoseconds>(steady_clock::now() - start).count() / 1e9;
+    std::println("\n=== Table7: {} {} in {:.2f}s, {}, {} ===",
+        ctx.opt.table7.empty() ? "built" : "opened", ctx.opt.table7.empty() ? "in memory" : ctx.opt.table7,
+        load_sec, format_bytes(static_cast<double>(table.bytes())), table.backing());
+
+    for (long long count : ctx.hand_counts()) {
+        std::println("\n  {:L} hands", count);
+        double generation_ns = 0;
+        const HandSet hands = ctx.hands(count, generation_ns);
+
+        for (unsigned threads : ctx.opt.threads) {
+            ThreadPool& pool = ctx.pools.get(threads);
+            std::println("\n  {} thread(s)", threads);
+            std::vector<std::string> names = evaluator_names(ctx);
+            names.emplace_back("table7/rank");
+            for (int lookahead : ctx.opt.lookaheads)
+                names.push_back(std::format("table7@{}", lookahead));
+            const size_t width = name_width(names);
+            print_table_header(width);
+            double computed_ns = 0;
+
+            auto row = [&](std::string name, auto&& run, int lookahead) {
+                Result r{ "table7", std::move(name), ctx.cards, threads, count, generation_ns };
+                std::vector<unsigned long long> sums;
+                r.samples_ns = measure(ctx.opt, [&] { sums.push_back(run()); });
+                set_checksum(r, sums);
+                if (lookahead >= 0) {
+                    r.metrics.emplace_back("lookahead", lookahead);
+                    if (computed_ns > 0) r.metrics.emplace_back("speedup_vs_kev", computed_ns / r.ns_per_hand());
                 }
-            );
-            end = steady_clock::now();
-        }
-
-        // Calculate statistics
-        auto elapsed_ns = duration_cast<nanoseconds>(end - start).count();
-        double elapsed_sec = elapsed_ns / 1'000'000'000.0;
-        double hands_per_sec = config.num_hands / elapsed_sec;
-        double ns_per_hand = elapsed_ns / static_cast<double>(config.num_hands);
-
-        // Print results
-        std::println("\nResults:");
-        std::println("  Total hands evaluated: {:L}", config.num_hands);
-        std::println("  Elapsed time: {:.4f} seconds", elapsed_sec);
-        std::println("  Hands per second: {:.0f}", hands_per_sec);
-        std::println("  Million hands/sec: {:.2f}M", hands_per_sec / 1'000'000.0);
-        std::println("  Nanoseconds per hand: {:.2f} ns", ns_per_hand);
-        std::println("  Microseconds per hand: {:.2f} us", ns_per_hand / 1000.0);
-        std::println("  Checksum (prevent optimization): {}", total);
-    }
-
-    // Frequency distribution check
-    std::println("\n\n=== Hand Distribution Check (100K hands) ===");
-    
-    std::array<int, 10> freq{};
-
-    if constexpr (CARD_COUNT == 5) {
-        auto dist_hands = generate_test_hands<5>(100'000);
-        for (const auto& hand : dist_hands) {
-            unsigned short value = evaluate_hand<5>(std::span{ hand });
-            int rank = hand_rank(value);
-            ++freq[rank];
+                print_row(r, width);
+                count_events(ctx, r, run);
+                ctx.results.push_back(std::move(r));
+                return ctx.results.back().ns_per_hand();
+            };
+
+            for (const Evaluator* e : ctx.evaluators()) {
+                const double ns = row(std::string(e->name), [&] { return evaluate_all(pool, *e, hands); }, -1);
+                if (e->name == "kev") computed_ns = ns;
+            }
+            row("table7/rank", [&] { return rank_table7(pool, hands); }, -1);
+            for (int lookahead : ctx.opt.lookaheads)
+                row(std::format("table7@{}", lookahead), [&] { return evaluate_table7(pool, table, hands, lookahead); }, lookahead);
         }
-    } else {
-        auto dist_hands = generate_test_hands<7>(100'000);
-        for (const auto& hand : dist_hands) {
-            unsigned short value = evaluate_hand<7>(std::span{ hand });
-            int rank = hand_rank(value);
-            ++freq[rank];
-        }
-    }
-
-    std::println("\nHand type distribution:");
-    for (int i = 1; i <= 9; ++i) {
-        double percentage = (freq[i] * 100.0) / 100'000;
-        std::println("  {:>15s}: {:6d} ({:5.2f}%)",
-            value_str[i], freq[i], percentage);
-    }
-
-    // Expected probabilities
-    if constexpr (CARD_COUNT == 5) {
-        std::println("\nExpected 5-card probabilities (for reference):");
-        std::println("  Straight Flush: ~0.0015%");
-        std::println("  Four of a Kind: ~0.024%");
-        std::println("  Full House:     ~0.144%");
-        std::println("  Flush:          ~0.197%");
-        std::println("  Straight:       ~0.392%");
-        std::println("  Three of Kind:  ~2.11%");
-        std::println("  Two Pair:       ~4.75%");
-        std::println("  One Pair:       ~42.3%");
-        std::println("  High Card:      ~50.1%");
-    } else {
-        std::println("\nExpected 7-card probabilities (for reference):");
-        std::println("  Straight Flush: ~0.03%");
-        std::println("  Four of a Kind: ~0.17%");
-        std::println("  Full House:     ~2.60%");
-        std::println("  Flush:          ~3.03%");
-        std::println("  Straight:       ~4.62%");
-        std::println("  Three of Kind:  ~4.83%");
-        std::println("  Two Pair:       ~23.5%");
-        std::println("  One Pair:       ~43.8%");
-        std::println("  High Card:      ~17.4%");
-    }
-
-    return 0;
-}
\ No newline at end of file
+    }
+}
+
+/****************************************************************
+    Noisy: evaluation next to a cache-thrashing neighbour
+****************************************************************/
+
+// A neighbour's working set. Each pass writes one word per cache line, so
+// its lines are dirty and evicting them costs a write-back too.
+class NoiseBuffer {
+public:
+    explicit NoiseBuffer(size_t bytes) : words_(bytes / sizeof(uint64_t), 1) {}
+
+    void pass() noexcept
+    {
+        for (size_t i = 0; i < words_.size(); i += 64 / sizeof(uint64_t))
+            words_[i] += i;
+    }
+
+private:
+    std::vector<uint64_t> words_;
+};
+
+// Score every hand in NOISE_BATCH_HANDS batches, each after a pass over the
+// worker's noise buffer. Only the batches are timed: eval_ns receives their
+// total per worker, averaged over the workers.
+template<typename Score>
+unsigned long long evaluate_noisy(ThreadPool& pool, const HandSet& hands, std::vector<NoiseBuffer>& noise,
+                                  Score&& score, double& eval_ns)
+{
+    struct alignas(64) Partial { unsigned long long sum = 0; double ns = 0; };
+    std::vector<Partial> partial(pool.size());
+    const size_t batches = (hands.size() + NOISE_BATCH_HANDS - 1) / NOISE_BATCH_HANDS;
+    pool.parallel_for(batches, [&](size_t b, size_t e, unsigned w) {
+        Partial& p = partial[w];
+        for (size_t k = b; k < e; ++k) {
+            noise[w].pass();
+            const size_t first = k * NOISE_BATCH_HANDS;
+            const size_t n = std::min(NOISE_BATCH_HANDS, hands.size() - first);
+            const auto start = steady_clock::now();
+            p.sum += score(hands.hand(first), n);
+            p.ns += static_cast<double>(duration_cast<nanoseconds>(steady_clock::now() - start).count());
+        }
+    });
+    unsigned long long sum = 0;
+    eval_ns = 0;
+    for (const auto& p : partial) {
+        sum += p.sum;
+        eval_ns += p.ns;
+    }
+    eval_ns /= pool.size();
+    return sum;
+}
+
+void run_noisy(Context& ctx)
+{
+    const long long count = ctx.opt.hands.empty() ? NOISE_HANDS : ctx.opt.hands.front();
+    std::println("\n=== Noisy: {}-card, {:L} hands in batches of {:L}, noise per thread ===", ctx.cards, count, NOISE_BATCH_HANDS);
+    double generation_ns = 0;
+    const HandSet hands = ctx.hands(count, generation_ns);
+
+    using ScoreFn = std::function<unsigned long long(const int*, size_t)>;
+    std::vector<std::pair<std::string, ScoreFn>> kernels;
+    for (const Evaluator* e : ctx.evaluators())
+        kernels.emplace_back(e->name, [e](const int* h, size_t n) { return e->checksum(h, n); });
+
+    // The 267 MB table only when there is a file to map; building it takes too long here
+    std::optional<Table7> table;
+    if (ctx.cards == 7 && !ctx.opt.table7.empty()) {
+        table.emplace(Table7::open(ctx.opt.table7));
+        kernels.emplace_back("table7", [&table](const int* h, size_t n) {
+            unsigned long long sum = 0;
+            table->eval_pipelined(h, n, DEFAULT_LOOKAHEAD, [&](size_t, unsigned short v) { sum += v; });
+            return sum;
+        });
+    }
+
+    std::vector<std::string> names;
+    for (const auto& [name, score] : kernels)
+        names.push_back(name);
+    const size_t width = name_width(names);
+
+    for (unsigned threads : ctx.opt.threads) {
+        ThreadPool& pool = ctx.pools.get(threads);
+        std::println("\n  {} thread(s), ns/hand by noise bytes", threads);
+        std::print("  {:<{}s}", "Evaluator", width);
+        for (long long bytes : ctx.opt.noise)
+            std::print(" {:>10s}", bytes ? format_bytes(static_cast<double>(bytes)) : "quiet");
+        std::println(" {:>9s}", "Slowdown");
+
+        for (const auto& [name, score] : kernels) {
+            std::print("  {:<{}s}", name, width);
+            double quiet_ns = 0;
+            double slowdown = 0;
+            bool consistent = true;
+            for (long long bytes : ctx.opt.noise) {
+                std::vector<NoiseBuffer> noise;
+                for (unsigned w = 0; w < pool.size(); ++w)
+                    noise.emplace_back(static_cast<size_t>(bytes));
+
+                Result r{ "noisy", std::format("{}/{}", name, bytes), ctx.cards, threads, count, generation_ns };
+                std::vector<unsigned long long> sums;
+                std::vector<double> eval_ns;
+                (void)measure(ctx.opt, [&] {
+                    double ns = 0;
+                    sums.push_back(evaluate_noisy(pool, hands, noise, score, ns));
+                    eval_ns.push_back(ns);
+                });
+                r.samples_ns.assign(eval_ns.end() - ctx.opt.repetitions, eval_ns.end());
+                set_checksum(r, sums);
+                consistent = consistent && r.checksum_consistent;
+                r.metrics.emplace_back("noise_bytes", static_cast<double>(bytes));
+                if (bytes == 0) quiet_ns = r.ns_per_hand();
+                slowdown = r.ns_per_hand() / quiet_ns;
+                r.metrics.emplace_back("slowdown_vs_quiet", slowdown);
+                std::print(" {:>10.3f}", r.ns_per_hand());
+                ctx.results.push_back(std::move(r));
+            }
+            std::println(" {:>8.2f}x{}", slowdown, consistent ? "" : "  INCONSISTENT");
+        }
+    }
+}
+
+/****************************************************************
+    Hugepages: the same work on 4 KB and on huge pages
+****************************************************************/
+
+void run_hugepages(Context& ctx)
+{
+    constexpr std::array<HugePages, 2> settings = { HugePages::Off, HugePages::On };
+    auto label = [](HugePages p) { return p == HugePages::On ? "huge" : "4k"; };
+
+    for (long long count : ctx.hand_counts()) {
+        const double bytes = static_cast<double>(count) * ctx.cards * sizeof(int);
+        std::println("\n=== Huge pages: {}-card, {:L} hands, {} ===", ctx.cards, count, format_bytes(bytes));
+        if (!ctx.opt.perf) std::println("  (add --perf for dTLB misses)");
+
+        std::map<std::string, double> small_ns;       // ns/hand on 4 KB pages, by row
+        std::vector<std::string> names = evaluator_names(ctx, "/huge");
+        if (ctx.cards == 7 && !ctx.opt.table7.empty())
+            names.push_back(std::format("table7@{}/huge", DEFAULT_LOOKAHEAD));
+        const size_t width = name_width(names);
+        auto row = [&](HugePages pages, unsigned threads, const std::string& name, double generation_ns, auto&& run) {
+            Result r{ "hugepages", std::format("{}/{}", name, label(pages)), ctx.cards, threads, count, generation_ns };
+            std::vector<unsigned long long> sums;
+            r.samples_ns = measure(ctx.opt, [&] { sums.push_back(run()); });
+            set_checksum(r, sums);
+            r.metrics.emplace_back("huge_pages", pages == HugePages::On);
+            const std::string key = std::format("{}@{}", name, threads);
+            if (pages == HugePages::Off) small_ns[key] = r.ns_per_hand();
+            else if (small_ns.contains(key)) r.metrics.emplace_back("speedup_vs_4k", small_ns[key] / r.ns_per_hand());
+            print_row(r, width);
+            count_events(ctx, r, run);
+            ctx.results.push_back(std::move(r));
+        };
+
+        for (HugePages pages : settings) {
+            double generation_ns = 0;
+            const HandSet hands = ctx.hands(count, generation_ns, pages);
+            std::println("\n  Hands on {}: {}, {} on huge pages, generated in {:.3f} s", label(pages),
+                to_string(hands.buffer().backing()), format_bytes(static_cast<double>(hands.buffer().huge_bytes())), generation_ns / 1e9);
+
+            // With a file, the table is mapped for 4 KB and copied to huge pages for huge
+            std::optional<Table7> table;
+            if (ctx.cards == 7 && !ctx.opt.table7.empty()) {
+                table.emplace(Table7::open(ctx.opt.table7, pages == HugePages::On ? Table7::Pages::Huge : Table7::Pages::Mapped));
+                std::println("  Table7: {}, {} on huge pages", table->backing(), format_bytes(static_cast<double>(table->huge_bytes())));
+            }
+
+            for (unsigned threads : ctx.opt.threads) {
+                ThreadPool& pool = ctx.pools.get(threads);
+                std::println("\n  {} thread(s)", threads);
+                print_table_header(width);
+                for (const Evaluator* e : ctx.evaluators())
+                    row(pages, threads, std::string(e->name), generation_ns, [&] { return evaluate_all(pool, *e, hands); });
+                if (table) {
+                    for (int lookahead : { 0, DEFAULT_LOOKAHEAD })
+                        row(pages, threads, std::format("table7@{}", lookahead), generation_ns,
+                            [&] { return evaluate_table7(pool, *table, hands, lookahead); });
+                }
+            }
+        }
+    }
+}
+
+void run_modes(Context& ctx)
+{
+    if (has_mode(ctx.opt, "throughput")) run_throughput(ctx);
+    if (has_mode(ctx.opt, "stream")) run_stream(ctx);
+
+    if (has_mode(ctx.opt, "scaling")) {
+        const long long count = ctx.hand_counts().front();
+        std::println("\n=== Scaling: {}-card, {:L} hands ===", ctx.cards, count);
+        double generation_ns = 0;
+        const HandSet hands = ctx.hands(count, generation_ns);
+        if (ctx.cards == 5) run_scaling<5>(ctx, hands, generation_ns);
+        else run_scaling<7>(ctx, hands, generation_ns);
+    }
+
+    if (has_mode(ctx.opt, "numa")) {
+        const long long count = ctx.hand_counts().front();
+        if (ctx.cards == 5) run_numa<5>(ctx, count);
+        else run_numa<7>(ctx, count);
+    }
+
+    if (has_mode(ctx.opt, "service")) run_service(ctx);
+    if (has_mode(ctx.opt, "distribution")) run_distribution(ctx);
+    if (has_mode(ctx.opt, "latency")) run_latency(ctx);
+    if (has_mode(ctx.opt, "paths")) run_paths(ctx);
+    if (has_mode(ctx.opt, "workingset")) run_working_set(ctx);
+    if (has_mode(ctx.opt, "prefetch")) run_prefetch(ctx);
+    if (has_mode(ctx.opt, "bitslice")) run_bitslice(ctx);
+    if (has_mode(ctx.opt, "branches")) run_branches(ctx);
+    if (has_mode(ctx.opt, "reorder")) run_reorder(ctx);
+    if (has_mode(ctx.opt, "table7")) run_table7(ctx);
+    if (has_mode(ctx.opt, "noisy")) run_noisy(ctx);
+    if (has_mode(ctx.opt, "hugepages")) run_hugepages(ctx);
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    bool list_only = false;
+    try {
+        if (!parse_options(argc, argv, opt, list_only))
+            return 0;
+        for (const auto& m : opt.modes) {
+            constexpr std::array<std::string_view, 17> known = {
+                "throughput", "stream", "scaling", "numa", "service", "distribution", "latency", "paths",
+                "workingset", "prefetch", "bitslice", "branches", "reorder", "table7", "noisy", "hugepages", "all" };
+            if (std::find(known.begin(), known.end(), m) == known.end())
+                throw std::invalid_argument("unknown mode: " + m);
+        }
+        for (const auto& name : opt.evaluators) {
+            if (std::none_of(poker::evaluators().begin(), poker::evaluators().end(),
+                    [&](const Evaluator& e) { return e.name == name; }))
+                throw std::invalid_argument("unknown evaluator: " + name + " (see --list)");
+        }
+    }
+    catch (const std::exception& e) {
+        std::println(stderr, "{}\n", e.what());
+        print_usage();
+        return 2;
+    }
+
+    if (list_only) {
+        for (const Evaluator& e : poker::evaluators())
+            std::println("  {:<14s} {}-card  {}", e.name, e.cards, e.description);
+        return 0;
+    }
+
+    try {
+        std::unique_ptr<HandFile> input;
+        if (!opt.input.empty()) {
+            input = std::make_unique<HandFile>(HandFile::open(opt.input));
+            if (input->size() == 0)
+                throw std::runtime_error(opt.input + ": no hands");
+            opt.cards = { input->card_count() };
+        }
+
+        std::println("=== Poker Hand Evaluator Benchmark ===");
+        std::println("Hardware threads: {}, repetitions: {} (+{} warmup), pinned: {}, seed: {}",
+            std::max(1u, std::thread::hardware_concurrency()), opt.repetitions, opt.warmup,
+            opt.pin ? "yes" : "no", opt.seed);
+        if (input)
+            std::println("Input: {} ({:L} {}-card hands)", opt.input, input->size(), input->card_count());
+
+        // Opened before any pool exists, so every worker thread inherits the counters
+        std::unique_ptr<PerfCounters> perf;
+        if (opt.perf) {
+            perf = std::make_unique<PerfCounters>();
+            if (perf->available()) {
+                std::string missing;
+                for (int i = 0; i < NUM_PERF_EVENTS; ++i)
+                    if (!perf->has(static_cast<PerfEvent>(i))) missing += " " + std::string(perf_event_names[i]);
+                std::println("Hardware counters: on{}", missing.empty() ? "" : " (not available:" + missing + ")");
+            } else {
+                std::println("Hardware counters: unavailable, {}; timing only", perf->reason());
+                perf.reset();
+            }
+        }
+
+        Pools pools(opt.pin);
+        std::vector<Result> results;
+        for (int cards : opt.cards) {
+            Context ctx{ opt, cards, input.get(), pools, results, perf.get() };
+            if (ctx.evaluators().empty()) {
+                std::println("\nNo {}-card evaluator matches --evaluator", cards);
+                continue;
+            }
+            run_modes(ctx);
+        }
+
+        const ProcessUsage usage = ProcessUsage::now();
+        const BufferPool::Stats buffers = buffer_pool().stats();
+        std::println("\nMemory: peak RSS {:.1f} MB, {:L} minor and {:L} major page faults; "
+            "batch buffers: {} leases, {} reused, peak {:.1f} MB mapped",
+            usage.peak_rss_bytes / 1e6, usage.minor_faults, usage.major_faults,
+            buffers.leases, buffers.reused, buffers.peak_mapped_bytes / 1e6);
+
+        if (!opt.json.empty()) {
+            write_json(opt.json, opt, results, usage, buffers);
+            std::println("\nResults written to {}", opt.json);
+        }
+
+        const bool consistent = std::all_of(results.begin(), results.end(),
+            [](const Result& r) { return r.checksum_consistent; });
+        if (!consistent)
+            std::println(stderr, "Checksums differed between repetitions");
+        return consistent ? 0 : 1;
+    }
+    catch (const std::exception& e) {
+        std::println(stderr, "{}", e.what());
+        return 1;
+    }
+}
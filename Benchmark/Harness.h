@@ -0,0 +1,587 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <format>
+#include <numeric>
+#include <print>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "Poker.h"
+#include "ThreadPool.h"
+#include "HandFile.h"
+#include "Prefetch.h"
+#include "HugePages.h"
+#include "BufferPool.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+/****************************************************************
+    Benchmark harness
+
+    Command-line options, hand generation, repeated timing with
+    median / MAD statistics, and a JSON writer for the results.
+    Every measurement becomes a Result: one row in the console
+    table and one object in the JSON "results" array.
+****************************************************************/
+
+namespace bench {
+
+    using namespace poker;
+    using namespace std::chrono;
+
+    struct Options {
+        std::vector<std::string> modes{ "throughput" };
+        std::vector<int> cards{ 5 };
+        std::vector<std::string> evaluators;       // empty = every evaluator for the card count
+        std::vector<unsigned> threads;             // empty = 1 and hardware_concurrency()
+        std::vector<long long> hands;              // empty = DEFAULT_HANDS_5 / DEFAULT_HANDS_7
+        int repetitions = 5;
+        int warmup = 1;
+        bool pin = false;
+        bool perf = false;                         // hardware counters (Linux perf_event_open)
+        uint64_t seed = 0;                         // 0 = random
+        std::string input;                         // .phb file instead of generated hands
+        std::string json;                          // write results here
+        int group = 1;                             // latency mode: hands per timed call group
+        std::string hgrm;                          // latency mode: .hgrm file prefix
+        long long ws_min = 4 << 10;                // workingset mode: smallest input, bytes
+        long long ws_max = 1 << 30;                // workingset mode: largest input, bytes
+        std::vector<int> lookaheads{ 0, 1, 2, 4, 8, 16, 32 };   // prefetch mode: distances, 0 = scalar
+        std::string table7;                        // table7 mode: .p7t file, empty = build in memory
+        std::vector<long long> noise{ 0, 256 << 10, 1 << 20, 4 << 20 };   // noisy mode: bytes per thread, 0 = quiet
+        bool huge_pages = false;                   // hand buffers on huge pages (HugePages.h)
+    };
+
+    inline constexpr long long DEFAULT_HANDS_5 = 20'000'000;
+    inline constexpr long long DEFAULT_HANDS_7 = 5'000'000;
+
+    inline void print_usage()
+    {
+        std::println(stderr,
+            "Usage: Benchmark [options]\n"
+            "  --mode M[,M...]        throughput, stream, scaling, numa, service, distribution, latency,\n"
+            "                         paths, workingset, prefetch, bitslice, branches, reorder, table7, noisy, hugepages, all\n"
+            "                         (default throughput)\n"
+            "  --cards 5|7[,...]      card counts to run (default 5)\n"
+            "  --evaluator NAME[,...] evaluators to run (default all for the card count; --list shows them)\n"
+            "  --threads N[,...]      thread counts (default 1 and all hardware threads)\n"
+            "  --hands N[,...]        hands per run, K/M/G suffixes allowed (default {}M 5-card, {}M 7-card)\n"
+            "  --reps N               timed repetitions per measurement (default 5)\n"
+            "  --warmup N             untimed repetitions first (default 1)\n"
+            "  --pin                  pin worker threads to CPUs\n"
+            "  --perf                 hardware counters per hand (Linux perf_event_open)\n"
+            "  --seed S               hand generation seed (default random)\n"
+            "  --input FILE.phb       use hands from a binary hand file (see Rescore --generate)\n"
+            "  --json FILE            write results as JSON\n"
+            "  --group N              latency mode: time N hands per TSC read (default 1, split by category)\n"
+            "  --hgrm PREFIX          latency mode: write PREFIX-<evaluator>-<cards>.hgrm histograms\n"
+            "  --ws-min BYTES         workingset mode: smallest input working set (default 4K)\n"
+            "  --ws-max BYTES         workingset mode: largest input working set (default 1G)\n"
+            "  --lookahead N[,...]    prefetch mode: pipeline distances, 0 = scalar (default 0,1,2,4,8,16,32)\n"
+            "  --table7 FILE          table7 mode: .p7t table from BuildTable7 (default: build in memory)\n"
+            "  --noise BYTES[,...]    noisy mode: per-thread buffer written between batches; a quiet\n"
+            "                         run (0) always comes first (default 0,256K,1M,4M)\n"
+            "  --huge-pages on|off    hand buffers on huge pages, every mode but hugepages (default off)\n"
+            "  --list                 list evaluators and exit",
+            DEFAULT_HANDS_5 / 1'000'000, DEFAULT_HANDS_7 / 1'000'000);
+    }
+
+    namespace harness_detail {
+
+        inline long long parse_count(std::string_view s)
+        {
+            long long scale = 1;
+            if (!s.empty()) {
+                switch (s.back()) {
+                case 'k': case 'K': scale = 1'000; break;
+                case 'm': case 'M': scale = 1'000'000; break;
+                case 'g': case 'G': case 'b': case 'B': scale = 1'000'000'000; break;
+                }
+                if (scale != 1) s.remove_suffix(1);
+            }
+            long long v = 0;
+            auto [p, ec] = std::from_chars(s.data(), s.data() + s.size(), v);
+            if (ec != std::errc{} || p != s.data() + s.size() || v <= 0)
+                throw std::invalid_argument("invalid number: " + std::string(s));
+            return v * scale;
+        }
+
+        // Byte count with binary K/M/G suffixes (4K = 4096)
+        inline long long parse_bytes(std::string_view s)
+        {
+            const long long decimal = parse_count(s);
+            if (s.empty()) return decimal;
+            switch (s.back()) {
+            case 'k': case 'K': return decimal / 1'000 * 1'024;
+            case 'm': case 'M': return decimal / 1'000'000 * 1'048'576;
+            case 'g': case 'G': return decimal / 1'000'000'000 * 1'073'741'824;
+            }
+            return decimal;
+        }
+
+        template<typename Fn>
+        void for_each_item(std::string_view list, Fn&& fn)
+        {
+            while (!list.empty()) {
+                const size_t comma = list.find(',');
+                fn(list.substr(0, comma));
+                if (comma == std::string_view::npos) break;
+                list.remove_prefix(comma + 1);
+            }
+        }
+
+    } // namespace harness_detail
+
+    // Parse argv into options. Returns false (after printing usage) on --help.
+    // Throws std::invalid_argument on a bad option.
+    inline bool parse_options(int argc, char** argv, Options& o, bool& list_only)
+    {
+        using namespace harness_detail;
+        list_only = false;
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view arg = argv[i];
+            auto value = [&]() -> std::string_view {
+                if (i + 1 >= argc) throw std::invalid_argument("missing value for " + std::string(arg));
+                return argv[++i];
+            };
+
+            if (arg == "--mode") {
+                o.modes.clear();
+                for_each_item(value(), [&](std::string_view m) { o.modes.emplace_back(m); });
+            } else if (arg == "--cards") {
+                o.cards.clear();
+                for_each_item(value(), [&](std::string_view c) {
+                    const long long n = parse_count(c);
+                    if (n != 5 && n != 7) throw std::invalid_argument("--cards must be 5 or 7");
+                    o.cards.push_back(static_cast<int>(n));
+                });
+            } else if (arg == "--evaluator") {
+                for_each_item(value(), [&](std::string_view e) { o.evaluators.emplace_back(e); });
+            } else if (arg == "--threads") {
+                for_each_item(value(), [&](std::string_view t) { o.threads.push_back(static_cast<unsigned>(parse_count(t))); });
+            } else if (arg == "--hands") {
+                for_each_item(value(), [&](std::string_view h) { o.hands.push_back(parse_count(h)); });
+            } else if (arg == "--reps") {
+                o.repetitions = static_cast<int>(parse_count(value()));
+            } else if (arg == "--warmup") {
+                const std::string_view v = value();
+                o.warmup = (v == "0") ? 0 : static_cast<int>(parse_count(v));
+            } else if (arg == "--pin") {
+                o.pin = true;
+            } else if (arg == "--perf") {
+                o.perf = true;
+            } else if (arg == "--seed") {
+                o.seed = static_cast<uint64_t>(parse_count(value()));
+            } else if (arg == "--input") {
+                o.input = value();
+            } else if (arg == "--json") {
+                o.json = value();
+            } else if (arg == "--group") {
+                o.group = static_cast<int>(parse_count(value()));
+            } else if (arg == "--hgrm") {
+                o.hgrm = value();
+            } else if (arg == "--ws-min") {
+                o.ws_min = parse_bytes(value());
+            } else if (arg == "--ws-max") {
+                o.ws_max = parse_bytes(value());
+            } else if (arg == "--lookahead") {
+                o.lookaheads.clear();
+                for_each_item(value(), [&](std::string_view d) {
+                    const long long n = d == "0" ? 0 : parse_count(d);
+                    if (n > MAX_LOOKAHEAD) throw std::invalid_argument(std::format("--lookahead is at most {}", MAX_LOOKAHEAD));
+                    o.lookaheads.push_back(static_cast<int>(n));
+                });
+            } else if (arg == "--table7") {
+                o.table7 = value();
+            } else if (arg == "--huge-pages") {
+                const std::string_view v = value();
+                if (v != "on" && v != "off") throw std::invalid_argument("--huge-pages takes on or off");
+                o.huge_pages = (v == "on");
+            } else if (arg == "--noise") {
+                o.noise.clear();
+                for_each_item(value(), [&](std::string_view b) { o.noise.push_back(b == "0" ? 0 : parse_bytes(b)); });
+                // Slowdown is measured against a quiet run, so one always comes first
+                std::erase(o.noise, 0);
+                o.noise.insert(o.noise.begin(), 0);
+            } else if (arg == "--list") {
+                list_only = true;
+            } else if (arg == "--help" || arg == "-h") {
+                print_usage();
+                return false;
+            } else {
+                throw std::invalid_argument("unknown option: " + std::string(arg));
+            }
+        }
+
+        if (o.threads.empty()) {
+            const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+            o.threads = { 1 };
+            if (hw > 1) o.threads.push_back(hw);
+        }
+        if (o.ws_min > o.ws_max) throw std::invalid_argument("--ws-min is larger than --ws-max");
+        if (o.seed == 0) o.seed = std::random_device{}() | (uint64_t{ std::random_device{}() } << 32);
+        return true;
+    }
+
+    [[nodiscard]] inline bool has_mode(const Options& o, std::string_view mode)
+    {
+        return std::any_of(o.modes.begin(), o.modes.end(),
+            [mode](const std::string& m) { return m == mode || m == "all"; });
+    }
+
+    /****************************************************************
+        Statistics
+    ****************************************************************/
+
+    struct Summary {
+        double median = 0;
+        double mad = 0;          // median absolute deviation
+        double min = 0;
+        double max = 0;
+        double mean = 0;
+    };
+
+    [[nodiscard]] inline double median_of(std::vector<double> v)
+    {
+        if (v.empty()) return 0;
+        const size_t mid = v.size() / 2;
+        std::nth_element(v.begin(), v.begin() + mid, v.end());
+        double m = v[mid];
+        if (v.size() % 2 == 0)
+            m = (m + *std::max_element(v.begin(), v.begin() + mid)) / 2;
+        return m;
+    }
+
+    [[nodiscard]] inline Summary summarize(const std::vector<double>& samples)
+    {
+        Summary s;
+        if (samples.empty()) return s;
+        s.median = median_of(samples);
+        std::vector<double> dev(samples.size());
+        std::transform(samples.begin(), samples.end(), dev.begin(),
+            [m = s.median](double x) { return std::abs(x - m); });
+        s.mad = median_of(std::move(dev));
+        s.min = *std::min_element(samples.begin(), samples.end());
+        s.max = *std::max_element(samples.begin(), samples.end());
+        s.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+        return s;
+    }
+
+    // Run fn() warmup + repetitions times; returns the timed runs in nanoseconds.
+    template<typename Fn>
+    [[nodiscard]] std::vector<double> measure(const Options& o, Fn&& fn)
+    {
+        for (int i = 0; i < o.warmup; ++i)
+            fn();
+        std::vector<double> samples;
+        samples.reserve(static_cast<size_t>(o.repetitions));
+        for (int i = 0; i < o.repetitions; ++i) {
+            const auto start = steady_clock::now();
+            fn();
+            samples.push_back(static_cast<double>(duration_cast<nanoseconds>(steady_clock::now() - start).count()));
+        }
+        return samples;
+    }
+
+    /****************************************************************
+        Results
+    ****************************************************************/
+
+    struct Result {
+        std::string mode;
+        std::string evaluator;
+        int cards = 0;
+        unsigned threads = 0;
+        long long hands = 0;                  // per timed run
+        double generation_ns = 0;             // 0 when not applicable
+        std::vector<double> samples_ns;       // one per repetition
+        unsigned long long checksum = 0;
+        bool checksum_consistent = true;      // every repetition agreed
+        std::vector<std::pair<std::string, double>> metrics;   // mode-specific extras
+
+        Result() = default;
+        Result(std::string mode, std::string evaluator, int cards, unsigned threads, long long hands,
+               double generation_ns = 0, std::vector<double> samples_ns = {}, unsigned long long checksum = 0)
+            : mode(std::move(mode)), evaluator(std::move(evaluator)), cards(cards), threads(threads), hands(hands),
+              generation_ns(generation_ns), samples_ns(std::move(samples_ns)), checksum(checksum) {}
+
+        [[nodiscard]] Summary summary() const { return summarize(samples_ns); }
+        [[nodiscard]] double mhands_per_sec() const
+        {
+            const double ns = summary().median;
+            return ns > 0 ? hands / ns * 1e3 : 0;
+        }
+        [[nodiscard]] double ns_per_hand() const { return hands ? summary().median / hands : 0; }
+    };
+
+    // Width of the Evaluator column: the longest row name, at least the heading's
+    [[nodiscard]] inline size_t name_width(const std::vector<std::string>& names)
+    {
+        size_t width = std::string_view("Evaluator").size();
+        for (const std::string& n : names)
+            width = std::max(width, n.size());
+        return width;
+    }
+
+    inline void print_table_header(size_t width)
+    {
+        std::println("  {:<{}s} {:>7s} {:>13s} {:>12s} {:>9s} {:>7s} {:>22s}  {}",
+            "Evaluator", width, "Threads", "Hands", "M hands/s", "ns/hand", "MAD", "min..max ms", "Checksum");
+    }
+
+    inline void print_row(const Result& r, size_t width)
+    {
+        const Summary s = r.summary();
+        std::println("  {:<{}s} {:>7d} {:>13L} {:>12.2f} {:>9.3f} {:>6.2f}% {:>10.2f}..{:<10.2f}  {}{}",
+            r.evaluator, width, r.threads, r.hands, r.mhands_per_sec(), r.ns_per_hand(),
+            s.median > 0 ? s.mad / s.median * 100 : 0.0, s.min / 1e6, s.max / 1e6,
+            r.checksum, r.checksum_consistent ? "" : "  INCONSISTENT");
+    }
+
+    namespace harness_detail {
+
+        inline std::string json_string(std::string_view s)
+        {
+            std::string out = "\"";
+            for (char c : s) {
+                switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) out += std::format("\\u{:04x}", c);
+                    else out += c;
+                }
+            }
+            return out + "\"";
+        }
+
+        inline std::string json_number(double v)
+        {
+            return std::isfinite(v) ? std::format("{}", v) : "null";
+        }
+
+        inline std::string host_name()
+        {
+#ifdef _WIN32
+            const char* name = std::getenv("COMPUTERNAME");
+            return name ? name : "unknown";
+#else
+            char name[256] = {};
+            return gethostname(name, sizeof(name) - 1) == 0 ? name : "unknown";
+#endif
+        }
+
+        inline std::string compiler_name()
+        {
+#if defined(__clang__)
+            return "clang " __clang_version__;
+#elif defined(__GNUC__)
+            return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+            return "msvc " + std::to_string(_MSC_FULL_VER);
+#else
+            return "unknown";
+#endif
+        }
+
+        inline std::string utc_timestamp()
+        {
+            const std::time_t now = std::time(nullptr);
+            std::tm tm{};
+#ifdef _WIN32
+            gmtime_s(&tm, &now);
+#else
+            gmtime_r(&now, &tm);
+#endif
+            char buf[32];
+            std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
+            return buf;
+        }
+
+    } // namespace harness_detail
+
+    // Write the run's options, memory use and results as one JSON document.
+    inline void write_json(const std::string& path, const Options& o, const std::vector<Result>& results,
+                           const ProcessUsage& usage, const BufferPool::Stats& buffers)
+    {
+        using namespace harness_detail;
+
+        FILE* f = std::fopen(path.c_str(), "wb");
+        if (!f) throw std::runtime_error("cannot open '" + path + "' for writing");
+
+        auto list = [](const auto& items, auto&& fmt) {
+            std::string s = "[";
+            for (size_t i = 0; i < items.size(); ++i)
+                s += (i ? ", " : "") + fmt(items[i]);
+            return s + "]";
+        };
+        auto num = [](auto v) { return std::to_string(v); };
+
+        std::println(f, "{{");
+        std::println(f, "  \"benchmark\": \"PokerEval\",");
+        std::println(f, "  \"timestamp\": {},", json_string(utc_timestamp()));
+        std::println(f, "  \"host\": {},", json_string(host_name()));
+        std::println(f, "  \"compiler\": {},", json_string(compiler_name()));
+#ifdef NDEBUG
+        std::println(f, "  \"build\": \"release\",");
+#else
+        std::println(f, "  \"build\": \"debug\",");
+#endif
+        std::println(f, "  \"hardware_threads\": {},", std::thread::hardware_concurrency());
+        std::println(f, "  \"options\": {{");
+        std::println(f, "    \"modes\": {},", list(o.modes, json_string));
+        std::println(f, "    \"cards\": {},", list(o.cards, num));
+        std::println(f, "    \"evaluators\": {},", list(o.evaluators, json_string));
+        std::println(f, "    \"threads\": {},", list(o.threads, num));
+        std::println(f, "    \"hands\": {},", list(o.hands, num));
+        std::println(f, "    \"repetitions\": {},", o.repetitions);
+        std::println(f, "    \"warmup\": {},", o.warmup);
+        std::println(f, "    \"pin\": {},", o.pin ? "true" : "false");
+        std::println(f, "    \"perf\": {},", o.perf ? "true" : "false");
+        std::println(f, "    \"seed\": {},", o.seed);
+        std::println(f, "    \"input\": {},", json_string(o.input));
+        std::println(f, "    \"group\": {},", o.group);
+        std::println(f, "    \"ws_min\": {},", o.ws_min);
+        std::println(f, "    \"ws_max\": {},", o.ws_max);
+        std::println(f, "    \"lookaheads\": {},", list(o.lookaheads, num));
+        std::println(f, "    \"table7\": {},", json_string(o.table7));
+        std::println(f, "    \"noise\": {},", list(o.noise, num));
+        std::println(f, "    \"huge_pages\": {}", o.huge_pages ? "true" : "false");
+        std::println(f, "  }},");
+        std::println(f, "  \"memory\": {{ \"peak_rss_bytes\": {}, \"minor_faults\": {}, \"major_faults\": {}, "
+            "\"buffer_leases\": {}, \"buffers_reused\": {}, \"peak_buffer_bytes\": {} }},",
+            usage.peak_rss_bytes, usage.minor_faults, usage.major_faults,
+            buffers.leases, buffers.reused, buffers.peak_mapped_bytes);
+        std::println(f, "  \"results\": [");
+
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            const Summary s = r.summary();
+            std::println(f, "    {{");
+            std::println(f, "      \"mode\": {},", json_string(r.mode));
+            std::println(f, "      \"evaluator\": {},", json_string(r.evaluator));
+            std::println(f, "      \"cards\": {},", r.cards);
+            std::println(f, "      \"threads\": {},", r.threads);
+            std::println(f, "      \"hands\": {},", r.hands);
+            std::println(f, "      \"generation_ns\": {},", json_number(r.generation_ns));
+            std::println(f, "      \"elapsed_ns\": {{ \"median\": {}, \"mad\": {}, \"min\": {}, \"max\": {}, \"mean\": {} }},",
+                json_number(s.median), json_number(s.mad), json_number(s.min), json_number(s.max), json_number(s.mean));
+            std::println(f, "      \"samples_ns\": {},", list(r.samples_ns, json_number));
+            std::println(f, "      \"mhands_per_sec\": {},", json_number(r.mhands_per_sec()));
+            std::println(f, "      \"ns_per_hand\": {},", json_number(r.ns_per_hand()));
+            std::println(f, "      \"checksum\": {},", r.checksum);
+            std::print(f, "      \"checksum_consistent\": {}", r.checksum_consistent ? "true" : "false");
+            if (!r.metrics.empty()) {
+                std::println(f, ",");
+                std::print(f, "      \"metrics\": {{ ");
+                for (size_t m = 0; m < r.metrics.size(); ++m)
+                    std::print(f, "{}{}: {}", m ? ", " : "", json_string(r.metrics[m].first), json_number(r.metrics[m].second));
+                std::print(f, " }}");
+            }
+            std::println(f, "");
+            std::println(f, "    }}{}", i + 1 < results.size() ? "," : "");
+        }
+        std::println(f, "  ]");
+        std::println(f, "}}");
+        std::fclose(f);
+    }
+
+    /****************************************************************
+        Hands
+    ****************************************************************/
+
+    // `count` hands of `cards` ints, back to back, in a buffer leased from
+    // `pool` and returned to it when the set is destroyed. The memory is
+    // uninitialised: the next config reuses it without a page fault.
+    class HandSet {
+    public:
+        HandSet() = default;
+        HandSet(int cards, size_t count, HugePages pages, BufferPool& pool = buffer_pool())
+            : cards(cards), count_(count), buffer_(pool.acquire(count * cards * sizeof(int), pages)) {}
+
+        int cards = 0;
+
+        [[nodiscard]] size_t size() const noexcept { return count_; }
+        [[nodiscard]] const int* data() const noexcept { return static_cast<const int*>(buffer_.data()); }
+        [[nodiscard]] int* data() noexcept { return static_cast<int*>(buffer_.data()); }
+        [[nodiscard]] const int* hand(size_t i) const noexcept { return data() + i * cards; }
+        [[nodiscard]] int* hand(size_t i) noexcept { return data() + i * cards; }
+        [[nodiscard]] const PageBuffer& buffer() const noexcept { return buffer_.buffer(); }
+
+    private:
+        size_t count_ = 0;
+        BufferPool::Lease buffer_;
+    };
+
+    // Deal n distinct random cards into hand
+    template<typename Rng>
+    void deal_hand(int* hand, int n, const Deck& deck, Rng& gen)
+    {
+        std::array<int, 52> indices;
+        std::iota(indices.begin(), indices.end(), 0);
+
+        // Partial Fisher-Yates shuffle
+        for (int j = 0; j < n; ++j) {
+            std::uniform_int_distribution<int> dist(j, 51);
+            std::swap(indices[j], indices[dist(gen)]);
+            hand[j] = deck[indices[j]];
+        }
+    }
+
+    // Hands per independently seeded generation block
+    inline constexpr size_t GENERATION_BLOCK = 64 * 1024;
+
+    // Seed of generation block `block`, so hands depend only on the seed
+    [[nodiscard]] constexpr uint64_t block_seed(uint64_t seed, uint64_t block) noexcept
+    {
+        return seed ^ (0x9E3779B97F4A7C15ULL * (block + 1));
+    }
+
+    // Random hands, generated in parallel; the same seed gives the same hands.
+    [[nodiscard]] inline HandSet generate_hands(int cards, long long count, uint64_t seed, ThreadPool& pool,
+                                                HugePages pages = HugePages::Off)
+    {
+        HandSet set(cards, static_cast<size_t>(count), pages);
+        const Deck deck = init_deck();
+        const size_t blocks = (static_cast<size_t>(count) + GENERATION_BLOCK - 1) / GENERATION_BLOCK;
+
+        pool.parallel_for(blocks, [&](size_t b, size_t e, unsigned) {
+            for (size_t block = b; block < e; ++block) {
+                std::mt19937_64 gen(block_seed(seed, block));
+                const size_t first = block * GENERATION_BLOCK;
+                const size_t last = std::min<size_t>(static_cast<size_t>(count), first + GENERATION_BLOCK);
+                for (size_t i = first; i < last; ++i)
+                    deal_hand(set.hand(i), cards, deck, gen);
+            }
+        });
+        return set;
+    }
+
+    // Hands from a .phb file, cycled if count exceeds the file.
+    // Throws std::runtime_error on a record that is not a hand.
+    [[nodiscard]] inline HandSet load_hands(const HandFile& file, long long count, HugePages pages = HugePages::Off)
+    {
+        HandSet set(file.card_count(), static_cast<size_t>(count), pages);
+        for (size_t i = 0; i < static_cast<size_t>(count); ++i)
+            if (!file.get_hand(i % file.size(), set.hand(i)))
+                throw std::runtime_error(std::format("hand file record {} has a card index above 51", i % file.size()));
+        return set;
+    }
+
+} // namespace bench
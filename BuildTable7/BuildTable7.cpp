@@ -0,0 +1,116 @@
+#include <print>
+#include <chrono>
+#include <array>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Poker.h"
+#include "Exhaustive.h"
+#include "ThreadPool.h"
+#include "Table7.h"
+
+/****************************************************************
+    Precomputed 7-card table builder
+
+    BuildTable7 <file.p7t> [--threads N] [--samples N]
+        Evaluates all 133,784,560 seven-card hands in parallel and
+        writes their values in colex-rank order (see Table7.h),
+        then checks the file.
+
+    BuildTable7 --check <file.p7t> [--threads N] [--samples N]
+        Only checks an existing file.
+
+    The check compares the value histogram with the reference
+    fingerprint from Exhaustive.h, then looks up N random hands
+    (default 1,000,000) and compares them with eval_7hand.
+****************************************************************/
+
+using namespace poker;
+using namespace std::chrono;
+
+namespace {
+
+    bool check(const std::string& path, uint64_t samples, ThreadPool& pool)
+    {
+        auto start = steady_clock::now();
+        const Table7 table = Table7::open(path);
+        const std::span<const uint16_t> values = table.values();
+
+        std::vector<ValueHistogram> local(pool.size());
+        pool.parallel_for(values.size(), [&](size_t b, size_t e, unsigned w) {
+            ValueHistogram& hist = local[w];
+            for (size_t i = b; i < e; ++i)
+                ++hist[values[i] <= NUM_HAND_VALUES ? values[i] : 0];
+        });
+        SweepResult sweep;
+        for (const auto& hist : local)
+            for (int v = 0; v <= NUM_HAND_VALUES; ++v)
+                sweep.values[v] += hist[v];
+        sweep.total = sweep.values[0];
+        for (int v = 1; v <= NUM_HAND_VALUES; ++v) {
+            sweep.total += sweep.values[v];
+            sweep.categories[hand_rank(static_cast<unsigned short>(v))] += sweep.values[v];
+            sweep.distinct += (sweep.values[v] != 0);
+        }
+        sweep.fingerprint = histogram_fingerprint(sweep.values);
+        const bool histogram_ok = sweep_matches_reference(sweep);
+
+        std::mt19937_64 gen(1);
+        std::array<int, 52> deck;
+        for (int i = 0; i < 52; ++i) deck[i] = card_table[i];
+        uint64_t mismatches = 0;
+        for (uint64_t i = 0; i < samples; ++i) {
+            for (int j = 0; j < 7; ++j)
+                std::swap(deck[j], deck[j + gen() % (52 - j)]);
+            if (table.eval(deck.data()) != eval_7hand(std::span<const int>(deck.data(), 7)))
+                ++mismatches;
+        }
+
+        const double sec = duration_cast<nanoseconds>(steady_clock::now() - start).count() / 1e9;
+        std::println("Checked {} in {:.2f}s", path, sec);
+        std::println("  histogram: {} (fingerprint {:016x}, {} distinct values)",
+            histogram_ok ? "matches reference" : "MISMATCH", sweep.fingerprint, sweep.distinct);
+        std::println("  {} random hands: {} mismatches", samples, mismatches);
+        return histogram_ok && mismatches == 0;
+    }
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string_view> args(argv + 1, argv + argc);
+    unsigned threads = 0;
+    uint64_t samples = 1'000'000;
+    bool check_only = false;
+
+    std::vector<std::string> positional;
+    for (size_t i = 0; i < args.size(); ++i) {
+        if (args[i] == "--threads" && i + 1 < args.size()) threads = static_cast<unsigned>(std::stoul(std::string(args[++i])));
+        else if (args[i] == "--samples" && i + 1 < args.size()) samples = std::stoull(std::string(args[++i]));
+        else if (args[i] == "--check") check_only = true;
+        else positional.emplace_back(args[i]);
+    }
+
+    if (positional.size() != 1) {
+        std::println(stderr, "Usage: BuildTable7 <file.p7t> [--threads N] [--samples N]");
+        std::println(stderr, "       BuildTable7 --check <file.p7t> [--threads N] [--samples N]");
+        return 2;
+    }
+
+    try {
+        ThreadPool pool({ .threads = threads });
+        if (!check_only) {
+            auto start = steady_clock::now();
+            Table7::write(positional[0], pool);
+            const double sec = duration_cast<nanoseconds>(steady_clock::now() - start).count() / 1e9;
+            std::println("Wrote {} seven-card values to {} in {:.2f}s ({:.2f}M hands/sec, {} threads)",
+                TABLE7_ENTRIES, positional[0], sec, TABLE7_ENTRIES / sec / 1e6, pool.size());
+        }
+        return check(positional[0], samples, pool) ? 0 : 1;
+    }
+    catch (const std::exception& e) {
+        std::println(stderr, "{}", e.what());
+        return 1;
+    }
+}
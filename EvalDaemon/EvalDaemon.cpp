@@ -0,0 +1,413 @@
+#include <print>
+#include <array>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <unordered_map>
+#include <algorithm>
+#include "Poker.h"
+#include "Equity.h"
+#include "EvalProtocol.h"
+#include "ThreadPool.h"
+
+/****************************************************************
+    Evaluation daemon
+
+    Serves EVAL5, EVAL7 and EQUITY requests (see EvalProtocol.h)
+    to local clients over a Unix domain socket, so services in any
+    language can share one loaded evaluator.
+
+    A single I/O thread runs a level-triggered epoll loop. Each
+    pass reads everything the ready clients have sent, decodes all
+    complete frames from every connection into one batch, evaluates
+    the batch (on the thread pool unless it is small and has no
+    equity requests), and appends the responses to each client's
+    output buffer. Requests that arrive while a batch is evaluated
+    form the next batch, so batches grow with load. A client whose
+    unread responses exceed MAX_BUFFERED_OUTPUT is not read from
+    until it catches up.
+
+    Equity requests are exact when the run-out count is at most
+    the request's max_boards (0 = no limit), and sampled otherwise;
+    the daemon lowers any limit above --max-boards so a single
+    preflop request cannot stall the loop.
+
+    Linux only. Stop with SIGINT or SIGTERM.
+
+    Usage: EvalDaemon [--socket PATH] [--threads N] [--max-boards N]
+****************************************************************/
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace poker;
+
+namespace {
+
+    constexpr std::string_view DEFAULT_SOCKET = "/tmp/pokereval.sock";
+
+    // Largest read per connection per pass, so one client cannot starve the rest
+    constexpr size_t READ_BYTES = 256 << 10;
+
+    // Stop reading a client with this many unsent response bytes
+    constexpr size_t MAX_BUFFERED_OUTPUT = 4 << 20;
+
+    // Batches below this size with no equity requests skip the thread pool
+    constexpr size_t INLINE_BATCH = 512;
+
+    constexpr int MAX_EVENTS = 256;
+
+    struct Connection {
+        int fd = -1;
+        std::vector<uint8_t> in;
+        std::vector<uint8_t> out;
+        size_t out_pos = 0;
+        uint32_t events = 0;     // current epoll interest
+        bool eof = false;        // client finished sending
+        bool failed = false;     // socket error; drop without replying
+    };
+
+    struct Pending {
+        Connection* conn;
+        protocol::Request request;
+        uint16_t value = 0;
+        std::array<float, MAX_SEATS> equity{};
+    };
+
+    struct Stats {
+        unsigned long long connections = 0;
+        unsigned long long requests = 0;
+        unsigned long long batches = 0;
+        unsigned long long pooled_batches = 0;
+        size_t max_batch = 0;
+    };
+
+    [[noreturn]] void fail(const char* what)
+    {
+        throw std::runtime_error(std::string(what) + ": " + std::strerror(errno));
+    }
+
+    void evaluate(Pending& p, uint32_t max_boards_cap)
+    {
+        using protocol::RequestType;
+        protocol::Request& r = p.request;
+        if (r.status != protocol::Status::Ok) return;
+
+        if (r.type == RequestType::Eval5) {
+            p.value = eval_5cards(r.cards[0], r.cards[1], r.cards[2], r.cards[3], r.cards[4]);
+        } else if (r.type == RequestType::Eval7) {
+            p.value = eval_7hand(r.cards);
+        } else {
+            uint32_t limit = r.max_boards;
+            if (max_boards_cap && (limit == 0 || limit > max_boards_cap)) limit = max_boards_cap;
+            const EquityResult e = evaluate_equity(r.equity, r.board_count, limit, r.id);
+            p.value = e.exact ? 1 : 0;
+            for (int i = 0; i < r.equity.players; ++i)
+                p.equity[i] = static_cast<float>(e.equity[i]);
+        }
+    }
+
+    class Daemon {
+    public:
+        Daemon(const std::string& path, unsigned threads, uint32_t max_boards)
+            : path_(path), max_boards_(max_boards), signals_(block_signals()),
+              pool_({ .threads = threads, .chunk_size = 16 })
+        {
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            if (path.size() >= sizeof(addr.sun_path))
+                throw std::invalid_argument("socket path too long: " + path);
+            std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+            listener_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (listener_ < 0) fail("socket");
+            ::unlink(path.c_str());
+            if (bind(listener_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) fail("bind");
+            if (listen(listener_, SOMAXCONN) != 0) fail("listen");
+
+            epoll_ = epoll_create1(EPOLL_CLOEXEC);
+            if (epoll_ < 0) fail("epoll_create1");
+            if (!watch(listener_, EPOLLIN, nullptr)) fail("epoll_ctl");
+            if (!watch(signals_, EPOLLIN, &signals_)) fail("epoll_ctl");
+        }
+
+        ~Daemon()
+        {
+            for (auto& [fd, conn] : connections_) ::close(fd);
+            if (epoll_ >= 0) ::close(epoll_);
+            if (signals_ >= 0) ::close(signals_);
+            if (listener_ >= 0) ::close(listener_);
+            ::unlink(path_.c_str());
+        }
+
+        void run()
+        {
+            std::println("Listening on {} ({} worker threads)", path_, pool_.size());
+
+            std::array<epoll_event, MAX_EVENTS> events;
+            std::vector<Pending> batch;
+            std::vector<Connection*> touched;
+
+            for (bool stop = false; !stop; ) {
+                const int n = epoll_wait(epoll_, events.data(), MAX_EVENTS, -1);
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    fail("epoll_wait");
+                }
+
+                for (int i = 0; i < n; ++i) {
+                    void* tag = events[i].data.ptr;
+                    if (tag == nullptr) {
+                        accept_all();
+                    } else if (tag == &signals_) {
+                        stop = true;
+                    } else {
+                        auto* conn = static_cast<Connection*>(tag);
+                        if (events[i].events & EPOLLERR) conn->failed = true;
+                        if (events[i].events & EPOLLOUT) flush(*conn);
+                        if (events[i].events & (EPOLLIN | EPOLLHUP)) read_requests(*conn, batch);
+                        touched.push_back(conn);
+                    }
+                }
+
+                if (!batch.empty())
+                    run_batch(batch);
+
+                for (Pending& p : batch) {
+                    if (p.conn->failed) continue;
+                    const int players = p.request.type == protocol::RequestType::Equity
+                        && p.request.status == protocol::Status::Ok ? p.request.equity.players : 0;
+                    protocol::encode_response(p.conn->out, p.request.id, p.request.status, p.value,
+                        std::span<const float>(p.equity.data(), static_cast<size_t>(players)));
+                }
+                batch.clear();
+
+                std::sort(touched.begin(), touched.end());
+                touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+                for (Connection* conn : touched)
+                    update(*conn);
+                touched.clear();
+            }
+
+            std::println("\nShutting down: {} connections, {} requests in {} batches "
+                "(mean {:.1f}, max {}, {} on the thread pool)",
+                stats_.connections, stats_.requests, stats_.batches,
+                stats_.batches ? static_cast<double>(stats_.requests) / stats_.batches : 0.0,
+                stats_.max_batch, stats_.pooled_batches);
+        }
+
+    private:
+        // Block SIGINT/SIGTERM (read through a signalfd instead) and SIGPIPE before
+        // the pool starts, so its worker threads inherit the mask.
+        static int block_signals()
+        {
+            sigset_t mask;
+            sigemptyset(&mask);
+            sigaddset(&mask, SIGINT);
+            sigaddset(&mask, SIGTERM);
+            sigaddset(&mask, SIGPIPE);
+            pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+            sigdelset(&mask, SIGPIPE);
+            const int fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+            if (fd < 0) fail("signalfd");
+            return fd;
+        }
+
+        // Add fd to the epoll set; false (errno set) if the kernel refuses
+        [[nodiscard]] bool watch(int fd, uint32_t events, void* tag) noexcept
+        {
+            epoll_event ev{};
+            ev.events = events;
+            ev.data.ptr = tag;
+            return epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &ev) == 0;
+        }
+
+        void accept_all()
+        {
+            for (;;) {
+                const int fd = accept4(listener_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (fd < 0) {
+                    if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR && errno != ECONNABORTED)
+                        std::println(stderr, "accept: {}", std::strerror(errno));
+                    return;
+                }
+                auto conn = std::make_unique<Connection>();
+                conn->fd = fd;
+                conn->events = EPOLLIN;
+                // One client the kernel cannot watch (ENOMEM, max_user_watches)
+                // is dropped; the daemon keeps serving the others
+                if (!watch(fd, conn->events, conn.get())) {
+                    std::println(stderr, "epoll_ctl: {}; dropping a new connection", std::strerror(errno));
+                    ::close(fd);
+                    continue;
+                }
+                connections_.emplace(fd, std::move(conn));
+                ++stats_.connections;
+            }
+        }
+
+        // Read what the client has sent and decode every complete frame into the batch.
+        void read_requests(Connection& conn, std::vector<Pending>& batch)
+        {
+            if (conn.failed || conn.eof) return;
+
+            size_t budget = READ_BYTES;
+            while (budget > 0) {
+                const size_t old = conn.in.size();
+                const size_t want = std::min<size_t>(budget, 64 << 10);
+                conn.in.resize(old + want);
+                const ssize_t got = ::read(conn.fd, conn.in.data() + old, want);
+                if (got <= 0) {
+                    conn.in.resize(old);
+                    if (got == 0) conn.eof = true;
+                    else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) conn.failed = true;
+                    break;
+                }
+                conn.in.resize(old + static_cast<size_t>(got));
+                budget -= static_cast<size_t>(got);
+            }
+
+            size_t pos = 0;
+            for (;;) {
+                Pending p{ &conn, {} };
+                const size_t used = protocol::decode_request(conn.in.data() + pos, conn.in.size() - pos, p.request);
+                if (used == 0) break;
+                batch.push_back(p);
+                pos += used;
+            }
+            conn.in.erase(conn.in.begin(), conn.in.begin() + static_cast<ptrdiff_t>(pos));
+        }
+
+        void run_batch(std::vector<Pending>& batch)
+        {
+            const bool has_equity = std::any_of(batch.begin(), batch.end(),
+                [](const Pending& p) { return p.request.type == protocol::RequestType::Equity; });
+
+            if (batch.size() < INLINE_BATCH && !has_equity) {
+                for (Pending& p : batch)
+                    evaluate(p, max_boards_);
+            } else {
+                pool_.parallel_for(batch.size(), [&](size_t b, size_t e, unsigned) {
+                    for (size_t i = b; i < e; ++i)
+                        evaluate(batch[i], max_boards_);
+                });
+                ++stats_.pooled_batches;
+            }
+
+            stats_.requests += batch.size();
+            ++stats_.batches;
+            stats_.max_batch = std::max(stats_.max_batch, batch.size());
+        }
+
+        // Write as much pending output as the socket takes.
+        void flush(Connection& conn)
+        {
+            while (!conn.failed && conn.out_pos < conn.out.size()) {
+                const ssize_t sent = ::send(conn.fd, conn.out.data() + conn.out_pos,
+                    conn.out.size() - conn.out_pos, MSG_NOSIGNAL);
+                if (sent < 0) {
+                    if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) conn.failed = true;
+                    break;
+                }
+                conn.out_pos += static_cast<size_t>(sent);
+            }
+            if (conn.out_pos == conn.out.size()) {
+                conn.out.clear();
+                conn.out_pos = 0;
+            }
+        }
+
+        // Stop watching conn, close it and free it
+        void close_connection(Connection& conn)
+        {
+            const int fd = conn.fd;
+            epoll_ctl(epoll_, EPOLL_CTL_DEL, fd, nullptr);
+            ::close(fd);
+            connections_.erase(fd);
+        }
+
+        // Send new responses, then close the connection or adjust its epoll interest.
+        void update(Connection& conn)
+        {
+            flush(conn);
+            const size_t unsent = conn.out.size() - conn.out_pos;
+            if (conn.failed || (conn.eof && unsent == 0)) {
+                close_connection(conn);
+                return;
+            }
+
+            uint32_t events = 0;
+            if (!conn.eof && unsent < MAX_BUFFERED_OUTPUT) events |= EPOLLIN;
+            if (unsent > 0) events |= EPOLLOUT;
+            if (events != conn.events) {
+                epoll_event ev{};
+                ev.events = events;
+                ev.data.ptr = &conn;
+                if (epoll_ctl(epoll_, EPOLL_CTL_MOD, conn.fd, &ev) != 0) {
+                    std::println(stderr, "epoll_ctl: {}; dropping a connection", std::strerror(errno));
+                    close_connection(conn);
+                    return;
+                }
+                conn.events = events;
+            }
+        }
+
+        std::string path_;
+        uint32_t max_boards_;
+        int signals_ = -1;
+        ThreadPool pool_;
+        int listener_ = -1;
+        int epoll_ = -1;
+        std::unordered_map<int, std::unique_ptr<Connection>> connections_;
+        Stats stats_;
+    };
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    std::string path(DEFAULT_SOCKET);
+    unsigned threads = 0;
+    uint32_t max_boards = 200'000;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) path = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc) threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        else if (arg == "--max-boards" && i + 1 < argc) max_boards = static_cast<uint32_t>(std::stoul(argv[++i]));
+        else {
+            std::println(stderr, "Usage: EvalDaemon [--socket PATH] [--threads N] [--max-boards N]");
+            return 2;
+        }
+    }
+
+    try {
+        Daemon daemon(path, threads, max_boards);
+        daemon.run();
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::println(stderr, "{}", e.what());
+        return 1;
+    }
+}
+
+#else
+
+int main()
+{
+    std::println(stderr, "EvalDaemon requires Linux (epoll and Unix domain sockets)");
+    return 1;
+}
+
+#endif
@@ -0,0 +1,251 @@
+#include <print>
+#include <chrono>
+#include <array>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <random>
+#include <thread>
+#include <numeric>
+#include <algorithm>
+#include "Poker.h"
+#include "EvalProtocol.h"
+#include "LatencyHistogram.h"
+
+/****************************************************************
+    Evaluation daemon load generator
+
+    Opens --connections connections to a running EvalDaemon, one
+    thread each, and keeps --pipeline requests in flight on every
+    connection until --requests have been answered in total. The
+    request mix is --equity percent flop equity requests (two or
+    three players, exact), with the rest split evenly between 5-
+    and 7-card evaluations.
+
+    Every 5- and 7-card answer is checked against the local
+    evaluator. Reports request throughput and send-to-response
+    latency percentiles over all connections.
+
+    Linux only.
+
+    Usage: EvalLoadGen [--socket PATH] [--connections C] [--pipeline D]
+                       [--requests N] [--equity P]
+****************************************************************/
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace poker;
+using namespace std::chrono;
+
+namespace {
+
+    constexpr std::string_view DEFAULT_SOCKET = "/tmp/pokereval.sock";
+
+    struct Options {
+        std::string socket{ DEFAULT_SOCKET };
+        unsigned connections = 4;
+        unsigned pipeline = 64;
+        unsigned long long requests = 1'000'000;
+        unsigned equity_percent = 1;
+    };
+
+    struct ClientResult {
+        LatencyHistogram latency;    // nanoseconds
+        unsigned long long completed = 0;
+        unsigned long long wrong = 0;
+        unsigned long long errors = 0;
+        std::string failure;
+    };
+
+    int connect_to(const std::string& path)
+    {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(addr.sun_path))
+            throw std::invalid_argument("socket path too long: " + path);
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+        const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            const std::string msg = "connect to " + path + ": " + std::strerror(errno);
+            if (fd >= 0) ::close(fd);
+            throw std::runtime_error(msg);
+        }
+        return fd;
+    }
+
+    void send_all(int fd, std::vector<uint8_t>& buf)
+    {
+        for (size_t pos = 0; pos < buf.size(); ) {
+            const ssize_t n = ::send(fd, buf.data() + pos, buf.size() - pos, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error(std::string("send: ") + std::strerror(errno));
+            }
+            pos += static_cast<size_t>(n);
+        }
+        buf.clear();
+    }
+
+    // One connection: keep `pipeline` requests in flight until `quota` are answered.
+    void run_client(const Options& opt, unsigned long long quota, uint64_t seed, ClientResult& result)
+    {
+        struct InFlight {
+            steady_clock::time_point sent;
+            unsigned short expected = 0;   // 0 for equity requests
+        };
+
+        const int fd = connect_to(opt.socket);
+        static constexpr Deck deck = init_deck();
+        std::mt19937_64 gen(seed);
+        std::array<uint8_t, 52> cards;
+        std::iota(cards.begin(), cards.end(), uint8_t{ 0 });
+
+        std::vector<InFlight> in_flight(opt.pipeline);
+        std::vector<uint8_t> out;
+        unsigned long long sent = 0;
+
+        // Queue request `id` (slot id % pipeline) into out.
+        auto queue = [&](uint32_t id) {
+            const bool equity = gen() % 100 < opt.equity_percent;
+            const int players = 2 + static_cast<int>(gen() % 2);
+            const int count = equity ? 2 * players + 3 : (gen() & 1) ? 7 : 5;
+            for (int j = 0; j < count; ++j)
+                std::swap(cards[j], cards[j + gen() % (52 - j)]);
+
+            InFlight& f = in_flight[id % opt.pipeline];
+            f.expected = 0;
+            if (equity) {
+                protocol::encode_equity(out, id, { cards.data(), static_cast<size_t>(2 * players) },
+                    { cards.data() + 2 * players, 3 }, 0);
+            } else {
+                protocol::encode_eval(out, id, { cards.data(), static_cast<size_t>(count) });
+                std::array<int, 7> hand;
+                for (int j = 0; j < count; ++j) hand[j] = deck[cards[j]];
+                f.expected = (count == 5) ? eval_5cards(hand[0], hand[1], hand[2], hand[3], hand[4]) : eval_7hand(hand);
+            }
+            f.sent = steady_clock::now();
+            ++sent;
+        };
+
+        for (uint32_t id = 0; id < opt.pipeline && sent < quota; ++id)
+            queue(id);
+        send_all(fd, out);
+
+        std::vector<uint8_t> in(64 << 10);
+        size_t have = 0;
+        while (result.completed < quota) {
+            const ssize_t n = ::read(fd, in.data() + have, in.size() - have);
+            if (n <= 0) {
+                if (n < 0 && errno == EINTR) continue;
+                ::close(fd);
+                throw std::runtime_error("daemon closed the connection");
+            }
+            have += static_cast<size_t>(n);
+            const auto now = steady_clock::now();
+
+            size_t pos = 0;
+            protocol::ResponseHeader h;
+            while (have - pos >= sizeof(h)) {
+                std::memcpy(&h, in.data() + pos, sizeof(h));
+                if (have - pos < sizeof(h) + h.length) break;
+                pos += sizeof(h) + h.length;
+
+                const InFlight& f = in_flight[h.id % opt.pipeline];
+                result.latency.record(static_cast<uint64_t>(duration_cast<nanoseconds>(now - f.sent).count()));
+                ++result.completed;
+                if (h.status != protocol::Status::Ok) ++result.errors;
+                else if (f.expected && h.value != f.expected) ++result.wrong;
+
+                if (sent < quota)
+                    queue(h.id + opt.pipeline);
+            }
+            std::memmove(in.data(), in.data() + pos, have - pos);
+            have -= pos;
+            if (!out.empty())
+                send_all(fd, out);
+        }
+        ::close(fd);
+    }
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) opt.socket = argv[++i];
+        else if (arg == "--connections" && i + 1 < argc) opt.connections = static_cast<unsigned>(std::stoul(argv[++i]));
+        else if (arg == "--pipeline" && i + 1 < argc) opt.pipeline = static_cast<unsigned>(std::stoul(argv[++i]));
+        else if (arg == "--requests" && i + 1 < argc) opt.requests = std::stoull(argv[++i]);
+        else if (arg == "--equity" && i + 1 < argc) opt.equity_percent = static_cast<unsigned>(std::stoul(argv[++i]));
+        else {
+            std::println(stderr, "Usage: EvalLoadGen [--socket PATH] [--connections C] [--pipeline D] "
+                "[--requests N] [--equity P]");
+            return 2;
+        }
+    }
+    opt.connections = std::max(1u, opt.connections);
+    opt.pipeline = std::max(1u, opt.pipeline);
+
+    std::println("=== EvalDaemon Load Test ===");
+    std::println("{} connections x {} in flight, {} requests, {}% equity\n",
+        opt.connections, opt.pipeline, opt.requests, opt.equity_percent);
+
+    std::vector<ClientResult> results(opt.connections);
+    auto start = steady_clock::now();
+    {
+        std::vector<std::jthread> clients;
+        for (unsigned c = 0; c < opt.connections; ++c) {
+            const unsigned long long quota = opt.requests / opt.connections + (c < opt.requests % opt.connections);
+            clients.emplace_back([&opt, &results, c, quota] {
+                try {
+                    run_client(opt, quota, 0x9E3779B97F4A7C15ULL * (c + 1), results[c]);
+                }
+                catch (const std::exception& e) {
+                    results[c].failure = e.what();
+                }
+            });
+        }
+    }
+    const double sec = duration_cast<nanoseconds>(steady_clock::now() - start).count() / 1e9;
+
+    LatencyHistogram latency;
+    unsigned long long completed = 0, wrong = 0, errors = 0;
+    int failed = 0;
+    for (const auto& r : results) {
+        latency.merge(r.latency);
+        completed += r.completed;
+        wrong += r.wrong;
+        errors += r.errors;
+        if (!r.failure.empty()) {
+            std::println(stderr, "connection failed: {}", r.failure);
+            ++failed;
+        }
+    }
+
+    std::println("  Completed:   {} requests in {:.4f}s ({:.2f}K requests/sec)", completed, sec, completed / sec / 1e3);
+    std::println("  Latency:     p50 {:.1f} us, p99 {:.1f} us, p999 {:.1f} us, max {:.1f} us",
+        latency.percentile(0.50) / 1e3, latency.percentile(0.99) / 1e3,
+        latency.percentile(0.999) / 1e3, latency.max() / 1e3);
+    std::println("  Errors:      {} error responses, {} wrong values, {} failed connections", errors, wrong, failed);
+
+    return (wrong || errors || failed) ? 1 : 0;
+}
+
+#else
+
+int main()
+{
+    std::println(stderr, "EvalLoadGen requires Linux (Unix domain sockets)");
+    return 1;
+}
+
+#endif
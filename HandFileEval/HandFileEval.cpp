@@ -0,0 +1,210 @@
+#include <print>
+#include <chrono>
+#include <array>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdio>
+#include <cstring>
+#include <charconv>
+#include <algorithm>
+#include "Poker.h"
+#include "CardParser.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+#include "BufferPool.h"
+
+/****************************************************************
+    Hand File Evaluator
+
+    Scores a text file with one hand per line, written the way
+    print_hand emits them ("Ac 4d 7c Jh 2s", 5 or 7 cards). The
+    input is memory-mapped and processed in windows; each window
+    is cut at line boundaries into chunks that the thread pool
+    parses, evaluates and formats in parallel, and the chunk
+    outputs are then written in input order.
+
+    Output has one line per input line: "<value> <category>", or
+    "0 Invalid" for a line that is not 5 or 7 valid, distinct
+    cards. Blank lines are skipped.
+
+    Usage: HandFileEval <input> [output | -] [--threads N] [--no-output]
+****************************************************************/
+
+using namespace poker;
+using namespace std::chrono;
+
+namespace {
+
+    // Bytes of input handed to the pool at a time
+    constexpr size_t WINDOW_BYTES = 64 << 20;
+
+    // Chunks per worker within a window, for load balance
+    constexpr int CHUNKS_PER_WORKER = 4;
+
+    // "<category>\n" strings, indexed by hand_rank(); 0 is "Invalid"
+    constexpr std::array<std::string_view, 10> category_lines = {
+        "Invalid\n",
+        "Straight Flush\n",
+        "Four of a Kind\n",
+        "Full House\n",
+        "Flush\n",
+        "Straight\n",
+        "Three of a Kind\n",
+        "Two Pair\n",
+        "One Pair\n",
+        "High Card\n"
+    };
+
+    struct Chunk {
+        const char* begin = nullptr;
+        const char* end = nullptr;
+        std::string out;
+        unsigned long long hands5 = 0;
+        unsigned long long hands7 = 0;
+        unsigned long long invalid = 0;
+        unsigned long long checksum = 0;
+    };
+
+    // Parse, evaluate and (optionally) format every line of one chunk.
+    void process_chunk(Chunk& chunk, bool write_output)
+    {
+        chunk.out.clear();
+        if (write_output)
+            chunk.out.reserve(static_cast<size_t>(chunk.end - chunk.begin));
+
+        std::array<int, 7> cards;
+        for (const char* line = chunk.begin; line < chunk.end; ) {
+            const char* nl = static_cast<const char*>(std::memchr(line, '\n', chunk.end - line));
+            const char* eol = nl ? nl : chunk.end;
+
+            const int n = parse_cards(line, eol, cards.data(), 7);
+            line = eol + 1;
+            if (n == 0) continue;
+
+            unsigned short value = 0;
+            if (n == 5) {
+                value = eval_5cards(cards[0], cards[1], cards[2], cards[3], cards[4]);
+                ++chunk.hands5;
+            } else if (n == 7) {
+                value = eval_7hand(cards);
+                ++chunk.hands7;
+            } else {
+                ++chunk.invalid;
+            }
+            chunk.checksum += value;
+
+            if (write_output) {
+                char digits[8];
+                auto [p, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+                chunk.out.append(digits, p);
+                chunk.out.push_back(' ');
+                chunk.out.append(category_lines[value ? hand_rank(value) : 0]);
+            }
+        }
+    }
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    std::string input, output;
+    unsigned threads = 0;
+    bool write_output = true;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        else if (arg == "--no-output") write_output = false;
+        else if (input.empty()) input = arg;
+        else if (output.empty()) output = arg;
+        else {
+            std::println(stderr, "Unexpected argument: {}", arg);
+            return 2;
+        }
+    }
+    if (input.empty()) {
+        std::println(stderr, "Usage: HandFileEval <input> [output | -] [--threads N] [--no-output]");
+        return 2;
+    }
+
+    try {
+        MappedFile in = MappedFile::open(input);
+        in.advise_sequential();
+
+        FILE* out = nullptr;
+        if (write_output) {
+            out = (output.empty() || output == "-") ? stdout : std::fopen(output.c_str(), "wb");
+            if (!out) {
+                std::println(stderr, "Cannot open output file '{}'", output);
+                return 1;
+            }
+            std::setvbuf(out, nullptr, _IOFBF, 1 << 20);
+        }
+
+        ThreadPool pool({ .threads = threads, .chunk_size = 1 });
+        std::vector<Chunk> chunks(pool.size() * CHUNKS_PER_WORKER);
+        Chunk totals;
+
+        auto start = steady_clock::now();
+
+        const char* pos = in.data();
+        const char* const file_end = in.data() + in.size();
+        while (pos < file_end) {
+            // Cut the next window, then its chunks, just after a newline
+            auto cut = [file_end](const char* from, size_t bytes) {
+                if (static_cast<size_t>(file_end - from) <= bytes) return file_end;
+                const char* p = from + bytes;
+                const char* nl = static_cast<const char*>(std::memchr(p, '\n', file_end - p));
+                return nl ? nl + 1 : file_end;
+            };
+            const char* window_end = cut(pos, WINDOW_BYTES);
+            const size_t per_chunk = static_cast<size_t>(window_end - pos) / chunks.size() + 1;
+
+            size_t used = 0;
+            for (const char* p = pos; p < window_end; ++used) {
+                chunks[used].begin = p;
+                chunks[used].end = std::min(cut(p, per_chunk), window_end);
+                p = chunks[used].end;
+            }
+
+            pool.parallel_for(used, [&](size_t b, size_t e, unsigned) {
+                for (size_t i = b; i < e; ++i)
+                    process_chunk(chunks[i], write_output);
+            });
+
+            for (size_t i = 0; i < used; ++i) {
+                if (write_output)
+                    std::fwrite(chunks[i].out.data(), 1, chunks[i].out.size(), out);
+                totals.hands5 += chunks[i].hands5;
+                totals.hands7 += chunks[i].hands7;
+                totals.invalid += chunks[i].invalid;
+                totals.checksum += chunks[i].checksum;
+                chunks[i].hands5 = chunks[i].hands7 = chunks[i].invalid = chunks[i].checksum = 0;
+            }
+            pos = window_end;
+        }
+
+        if (out) {
+            std::fflush(out);
+            if (out != stdout) std::fclose(out);
+        }
+        auto end = steady_clock::now();
+
+        const double sec = duration_cast<nanoseconds>(end - start).count() / 1e9;
+        const unsigned long long hands = totals.hands5 + totals.hands7;
+        std::println(stderr, "Evaluated {} hands ({} five-card, {} seven-card, {} invalid lines) on {} threads",
+            hands, totals.hands5, totals.hands7, totals.invalid, pool.size());
+        std::println(stderr, "Elapsed: {:.4f} s, {:.2f} GB/s, {:.2f}M hands/sec",
+            sec, in.size() / sec / 1e9, hands / sec / 1e6);
+        std::println(stderr, "Checksum: {}", totals.checksum);
+        const ProcessUsage usage = ProcessUsage::now();
+        std::println(stderr, "Peak RSS {:.1f} MB, {} minor and {} major page faults",
+            usage.peak_rss_bytes / 1e6, usage.minor_faults, usage.major_faults);
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::println(stderr, "{}", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,214 @@
+#include <print>
+#include <chrono>
+#include <array>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include "Poker.h"
+#include "Showdown.h"
+#include "HandHistory.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+
+/****************************************************************
+    Hand History Audit
+
+    Replays Hold'em hand history logs and checks every showdown's
+    reported winners against the evaluator. Each file is memory-
+    mapped and processed in windows cut at record boundaries, in
+    two timed stages:
+
+      parse     the window is split into chunks (each worker finds
+                its own first record), and every record is parsed
+                into a HandRecord in parallel
+      evaluate  every parsed showdown goes through
+                evaluate_showdown() in parallel and is compared
+                with the claimed winners
+
+    Mismatches are printed as they are found (up to --max-report),
+    followed by the record counts and per-stage throughput.
+
+    Usage: HandHistoryAudit <log>... [--threads N] [--max-report K]
+****************************************************************/
+
+using namespace poker;
+using namespace std::chrono;
+
+namespace {
+
+    // Bytes of log handed to the pool at a time
+    constexpr size_t WINDOW_BYTES = 64 << 20;
+
+    // Chunks per worker within a window, for load balance
+    constexpr int CHUNKS_PER_WORKER = 4;
+
+    struct Chunk {
+        const char* begin = nullptr;
+        const char* end = nullptr;
+        std::vector<HandRecord> records;
+        std::vector<size_t> mismatches;     // indices into records
+        std::array<unsigned long long, 4> status{};
+        unsigned long long players = 0;
+    };
+
+    struct Totals {
+        unsigned long long bytes = 0;
+        std::array<unsigned long long, 4> status{};
+        unsigned long long players = 0;
+        unsigned long long mismatches = 0;
+        double parse_sec = 0;
+        double eval_sec = 0;
+    };
+
+    void parse_chunk(Chunk& chunk)
+    {
+        chunk.records.clear();
+        HandRecord record;
+        for (const char* p = chunk.begin; p < chunk.end; ) {
+            const char* next = find_record_start(p + 1, p, chunk.end);
+            const RecordStatus status = parse_hand_record(p, next, record);
+            ++chunk.status[static_cast<int>(status)];
+            if (status == RecordStatus::Showdown)
+                chunk.records.push_back(record);
+            p = next;
+        }
+    }
+
+    void evaluate_chunk(Chunk& chunk)
+    {
+        chunk.mismatches.clear();
+        for (size_t i = 0; i < chunk.records.size(); ++i) {
+            const HandRecord& record = chunk.records[i];
+            chunk.players += record.showdown.players;
+            if (!showdown_matches(record, evaluate_showdown(record.showdown)))
+                chunk.mismatches.push_back(i);
+        }
+    }
+
+    std::string winner_names(const HandRecord& record, uint16_t mask)
+    {
+        std::string s;
+        for (int p = 0; p < record.showdown.players; ++p) {
+            if (!(mask >> p & 1)) continue;
+            if (!s.empty()) s += ", ";
+            s += record.names[p];
+        }
+        return s.empty() ? "nobody" : s;
+    }
+
+    void report_mismatch(const std::string& path, const HandRecord& record)
+    {
+        const ShowdownResult result = evaluate_showdown(record.showdown);
+        std::println("MISMATCH {} hand #{}: reported {}; evaluator says {} ({})",
+            path, record.id, winner_names(record, record.claimed),
+            winner_names(record, result.winners), value_str[hand_rank(result.best)]);
+    }
+
+    void audit_file(const std::string& path, ThreadPool& pool, std::vector<Chunk>& chunks,
+        Totals& totals, unsigned long long max_report)
+    {
+        MappedFile in = MappedFile::open(path);
+        in.advise_sequential();
+
+        const char* const file_begin = in.data();
+        const char* const file_end = in.data() + in.size();
+        const char* pos = find_record_start(file_begin, file_begin, file_end);
+
+        while (pos < file_end) {
+            auto parse_start = steady_clock::now();
+
+            // Cut the window at a record start, then let each chunk find its own
+            const char* window_end = (static_cast<size_t>(file_end - pos) <= WINDOW_BYTES)
+                ? file_end : find_record_start(pos + WINDOW_BYTES, file_begin, file_end);
+            const size_t per_chunk = static_cast<size_t>(window_end - pos) / chunks.size() + 1;
+
+            pool.parallel_for(chunks.size(), [&](size_t b, size_t e, unsigned) {
+                for (size_t i = b; i < e; ++i) {
+                    auto boundary = [&](size_t k) {
+                        if (k == 0) return pos;
+                        const size_t offset = k * per_chunk;
+                        if (offset >= static_cast<size_t>(window_end - pos)) return window_end;
+                        return find_record_start(pos + offset, pos, window_end);
+                    };
+                    chunks[i].begin = boundary(i);
+                    chunks[i].end = boundary(i + 1);
+                    parse_chunk(chunks[i]);
+                }
+            });
+
+            auto eval_start = steady_clock::now();
+            pool.parallel_for(chunks.size(), [&](size_t b, size_t e, unsigned) {
+                for (size_t i = b; i < e; ++i)
+                    evaluate_chunk(chunks[i]);
+            });
+            auto eval_end = steady_clock::now();
+
+            totals.parse_sec += duration_cast<nanoseconds>(eval_start - parse_start).count() / 1e9;
+            totals.eval_sec += duration_cast<nanoseconds>(eval_end - eval_start).count() / 1e9;
+
+            for (Chunk& chunk : chunks) {
+                for (size_t i : chunk.mismatches)
+                    if (totals.mismatches++ < max_report)
+                        report_mismatch(path, chunk.records[i]);
+                for (int s = 0; s < 4; ++s) totals.status[s] += chunk.status[s];
+                totals.players += chunk.players;
+                chunk.status = {};
+                chunk.players = 0;
+            }
+            pos = window_end;
+        }
+        totals.bytes += in.size();
+    }
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> files;
+    unsigned threads = 0;
+    unsigned long long max_report = 100;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        else if (arg == "--max-report" && i + 1 < argc) max_report = std::stoull(argv[++i]);
+        else files.emplace_back(arg);
+    }
+    if (files.empty()) {
+        std::println(stderr, "Usage: HandHistoryAudit <log>... [--threads N] [--max-report K]");
+        return 2;
+    }
+
+    try {
+        ThreadPool pool({ .threads = threads, .chunk_size = 1 });
+        std::vector<Chunk> chunks(pool.size() * CHUNKS_PER_WORKER);
+        Totals totals;
+
+        for (const std::string& path : files)
+            audit_file(path, pool, chunks, totals, max_report);
+
+        const auto showdowns = totals.status[static_cast<int>(RecordStatus::Showdown)];
+        unsigned long long records = 0;
+        for (auto n : totals.status) records += n;
+
+        std::println("\n=== Hand History Audit ({} files, {} threads) ===", files.size(), pool.size());
+        std::println("  Records:              {:12d}", records);
+        std::println("  Showdowns checked:    {:12d}", showdowns);
+        std::println("  No showdown:          {:12d}", totals.status[static_cast<int>(RecordStatus::NoShowdown)]);
+        std::println("  Unsupported:          {:12d}", totals.status[static_cast<int>(RecordStatus::Unsupported)]);
+        std::println("  Malformed:            {:12d}", totals.status[static_cast<int>(RecordStatus::Malformed)]);
+        std::println("  Winner mismatches:    {:12d}", totals.mismatches);
+        std::println("");
+        std::println("  Parse:    {:.4f} s, {:.2f} GB/s, {:.2f}M records/sec",
+            totals.parse_sec, totals.bytes / totals.parse_sec / 1e9, records / totals.parse_sec / 1e6);
+        std::println("  Evaluate: {:.4f} s, {:.2f}M showdowns/sec, {:.2f}M hands/sec",
+            totals.eval_sec, showdowns / totals.eval_sec / 1e6, totals.players / totals.eval_sec / 1e6);
+
+        return totals.mismatches == 0 ? 0 : 1;
+    }
+    catch (const std::exception& e) {
+        std::println(stderr, "{}", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "Poker.h"
+#include "CardParser.h"
+#include "ThreadPool.h"
+
+/****************************************************************
+    Batch evaluation of caller-owned card arrays
+
+    Shared by the C library (PokerEvalLib) and the Python module
+    (PyPokerEval). Hands arrive as N cards each in the caller's
+    own encoding. Each hand is validated and converted to Cactus
+    Kev form on the stack, then evaluated, and its value written.
+    A hand with a bad or repeated card gets value 0, and the batch
+    reports that one occurred.
+
+    The encoding is a policy with a static index(card) returning
+    the deck index (suit * 13 + rank) or -1:
+
+        IndexCards        uint8 deck indices
+        KevCards          int32 Cactus Kev cards
+        IndexOrKevCards   int32, either of the above
+****************************************************************/
+
+namespace poker {
+
+    // Batches smaller than this run on the calling thread even when parallel
+    inline constexpr size_t BATCH_PARALLEL_MIN_HANDS = 32 * 1024;
+
+    // The pool every parallel batch in the process runs on
+    [[nodiscard]] inline ThreadPool& batch_pool()
+    {
+        static ThreadPool pool({ .threads = 0, .chunk_size = 16 * 1024 });
+        return pool;
+    }
+
+    // Deck index of a Cactus Kev card, or -1 if it is not one of the 52 cards.
+    [[nodiscard]] constexpr int kev_card_index(int32_t card) noexcept
+    {
+        const int rank = RANK(card) - Deuce;
+        const int suit = (card & CLUB) ? 0 : (card & DIAMOND) ? 1 : (card & HEART) ? 2 : 3;
+        if (rank < 0 || rank > 12) return -1;
+        const int index = suit * 13 + rank;
+        return card_table[index] == card ? index : -1;
+    }
+
+    struct IndexCards {
+        [[nodiscard]] static constexpr int index(uint8_t c) noexcept { return c < 52 ? c : -1; }
+    };
+
+    struct KevCards {
+        [[nodiscard]] static constexpr int index(int32_t c) noexcept { return kev_card_index(c); }
+    };
+
+    struct IndexOrKevCards {
+        [[nodiscard]] static constexpr int index(int32_t c) noexcept { return (c >= 0 && c < 52) ? c : kev_card_index(c); }
+    };
+
+    // Evaluate hands [begin, end) of N cards each; returns false if any had a bad card.
+    template<int N, typename From, typename T>
+    bool eval_batch_range(const T* cards, size_t begin, size_t end, uint16_t* values) noexcept
+    {
+        bool ok = true;
+        std::array<int, N> hand;
+        for (size_t i = begin; i < end; ++i) {
+            const T* in = cards + i * N;
+            uint64_t seen = 0;
+            int c = 0;
+            for (; c < N; ++c) {
+                const int index = From::index(in[c]);
+                if (index < 0 || (seen >> index & 1)) break;
+                seen |= uint64_t{ 1 } << index;
+                hand[c] = card_table[index];
+            }
+            if (c < N) {
+                values[i] = 0;
+                ok = false;
+            } else if constexpr (N == 5) {
+                values[i] = eval_5cards(hand[0], hand[1], hand[2], hand[3], hand[4]);
+            } else {
+                values[i] = eval_7hand(hand);
+            }
+        }
+        return ok;
+    }
+
+    // Evaluate `count` hands, on batch_pool() when parallel and the batch is
+    // large enough. Returns false if any hand had a bad card. Throws only if
+    // the pool cannot run the work.
+    template<int N, typename From, typename T>
+    bool eval_batch(const T* cards, size_t count, uint16_t* values, bool parallel)
+    {
+        if (!parallel || count < BATCH_PARALLEL_MIN_HANDS)
+            return eval_batch_range<N, From>(cards, 0, count, values);
+
+        std::atomic<bool> all_ok{ true };
+        batch_pool().parallel_for(count, [&](size_t b, size_t e, unsigned) {
+            if (!eval_batch_range<N, From>(cards, b, e, values))
+                all_ok.store(false, std::memory_order_relaxed);
+        });
+        return all_ok.load();
+    }
+
+} // namespace poker
@@ -0,0 +1,416 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "Poker.h"
+
+#if defined(__BMI2__) || (defined(_MSC_VER) && defined(__AVX2__))
+#include <immintrin.h>
+#define POKER_HAS_PEXT 1
+#else
+#define POKER_HAS_PEXT 0
+#endif
+
+/****************************************************************
+    Bit-sliced evaluator (experimental)
+
+    Scores 64 * Words hands at once with AND / OR / XOR and no
+    table lookups. A block of hands is transposed into 52
+    bit-planes, one per card, where bit j of a plane says whether
+    hand j holds that card:
+
+        BitSlicedBlock<4> block;                // 256 hands
+        block.load(hands, n, 7);                // transpose
+        block.evaluate();                       // boolean logic
+        block.store(values, n);                 // Cactus Kev values
+
+    evaluate() derives every predicate for all lanes at once:
+    rank multiplicities from a per-rank adder over the four suits,
+    flushes from a per-suit counter over the thirteen ranks,
+    straights as ANDs of five adjacent rank planes, and the top
+    k ranks of a mask with a thermometer counter. The result per
+    lane is a one-hot category plus two 13-bit tie-break masks,
+    the primary ranks (quad, trips, pairs, straight top, flush
+    ranks) and the kickers. store() turns those into Cactus Kev
+    values arithmetically, by ranking the masks in the combinatorial
+    number system, so nothing depends on the lookup tables.
+
+    Hands of 5 to 7 cards. BitLanes<1> is one uint64_t; wider
+    lanes are arrays of them that the compiler can keep in AVX2
+    or AVX-512 registers.
+****************************************************************/
+
+namespace poker {
+
+    // 64 * Words one-bit lanes
+    template<int Words>
+    struct BitLanes {
+        std::array<uint64_t, Words> w{};
+
+        friend constexpr BitLanes operator&(BitLanes a, const BitLanes& b) noexcept
+        {
+            for (int i = 0; i < Words; ++i) a.w[i] &= b.w[i];
+            return a;
+        }
+
+        friend constexpr BitLanes operator|(BitLanes a, const BitLanes& b) noexcept
+        {
+            for (int i = 0; i < Words; ++i) a.w[i] |= b.w[i];
+            return a;
+        }
+
+        friend constexpr BitLanes operator^(BitLanes a, const BitLanes& b) noexcept
+        {
+            for (int i = 0; i < Words; ++i) a.w[i] ^= b.w[i];
+            return a;
+        }
+
+        friend constexpr BitLanes operator~(BitLanes a) noexcept
+        {
+            for (int i = 0; i < Words; ++i) a.w[i] = ~a.w[i];
+            return a;
+        }
+
+        constexpr BitLanes& operator&=(const BitLanes& b) noexcept { return *this = *this & b; }
+        constexpr BitLanes& operator|=(const BitLanes& b) noexcept { return *this = *this | b; }
+        constexpr BitLanes& operator^=(const BitLanes& b) noexcept { return *this = *this ^ b; }
+
+        constexpr void set(size_t lane) noexcept { w[lane / 64] |= uint64_t{ 1 } << (lane % 64); }
+
+        // Call fn(lane) for every set lane
+        template<typename Fn>
+        constexpr void for_each_lane(Fn&& fn) const noexcept
+        {
+            for (int i = 0; i < Words; ++i)
+                for (uint64_t bits = w[i]; bits; bits &= bits - 1)
+                    fn(static_cast<size_t>(i) * 64 + static_cast<size_t>(std::countr_zero(bits)));
+        }
+    };
+
+    namespace bitslice_detail {
+
+        inline constexpr int RANKS = 13;
+
+        // C(n, k) for n <= 13, k <= 5; row 14 is all zero, the sentinel colex reads
+        inline constexpr auto binomial = [] {
+            std::array<std::array<int, 6>, RANKS + 2> c{};
+            for (int n = 0; n <= RANKS; ++n) {
+                c[n][0] = 1;
+                for (int k = 1; k <= 5 && k <= n; ++k)
+                    c[n][k] = c[n - 1][k - 1] + (k <= n - 1 ? c[n - 1][k] : 0);
+            }
+            return c;
+        }();
+
+        // Position of a mask of up to five ranks among the subsets of its size
+        // in ascending order (combinatorial number system). Always five steps,
+        // so it does not branch on the number of ranks.
+        [[nodiscard]] constexpr int colex(unsigned mask) noexcept
+        {
+            int rank = 0;
+            for (int i = 1; i <= 5; ++i, mask &= mask - 1)
+                rank += binomial[std::countr_zero(mask | 1u << (RANKS + 1))][i];
+            return rank;
+        }
+
+        // k-subsets of an n-rank space that beat mask
+        [[nodiscard]] constexpr int subsets_above(unsigned mask, int n, int k) noexcept
+        {
+            return binomial[n][k] - 1 - colex(mask);
+        }
+
+        // Drop the ranks in `removed` from mask, closing the gaps
+        [[nodiscard]] constexpr unsigned compress(unsigned mask, unsigned removed) noexcept
+        {
+#if POKER_HAS_PEXT
+            if (!std::is_constant_evaluated())
+                return _pext_u32(mask, ~removed & 0x1FFF);
+#endif
+            while (removed) {
+                const int p = std::bit_width(removed) - 1;
+                removed &= ~(1u << p);
+                mask = (mask & ((1u << p) - 1)) | ((mask >> (p + 1)) << p);
+            }
+            return mask;
+        }
+
+        // Straights (the wheel included) that beat a five-rank mask
+        [[nodiscard]] constexpr int straights_above(unsigned mask) noexcept
+        {
+            int n = mask < 0x100F;
+            for (int low = 0; low <= 8; ++low)
+                n += mask < (0x1Fu << low);
+            return n;
+        }
+
+        // Every category's Cactus Kev values, from its first (best) value:
+        //   base + per_top * (12 - top primary rank)
+        //        + per_primary * (primary subsets above, of size primary_k)
+        //        + (kicker subsets above among the kicker_n ranks left)
+        //        - (straights above, for flushes and high cards)
+        struct CategoryLayout {
+            int base, per_top, per_primary, primary_k, kicker_n, kicker_k;
+            bool skips_straights;
+        };
+
+        inline constexpr std::array<CategoryLayout, 10> layouts = { {
+            { 0, 0, 0, 0, 0, 0, false },
+            { 1, 1, 0, 0, 0, 0, false },           // straight flush: top card
+            { 11, 12, 0, 0, 12, 1, false },        // quads, kicker
+            { 167, 12, 0, 0, 12, 1, false },       // trips, pair
+            { 323, 0, 1, 5, 0, 0, true },          // flush: five ranks
+            { 1600, 1, 0, 0, 0, 0, false },        // straight: top card
+            { 1610, 66, 0, 0, 12, 2, false },      // trips, two kickers
+            { 2468, 0, 11, 2, 11, 1, false },      // two pairs, kicker
+            { 3326, 220, 0, 0, 12, 3, false },     // pair, three kickers
+            { 6186, 0, 1, 5, 0, 0, true },         // high card: five ranks
+        } };
+
+        // Cactus Kev value from a category (HandRank) and the 13-bit
+        // primary and kicker rank masks (bit 0 = deuce, bit 12 = ace).
+        // A straight's primary mask holds only its top card, the five
+        // for a wheel.
+        [[nodiscard]] constexpr unsigned short kev_value(int category, unsigned primary, unsigned kicker) noexcept
+        {
+            const CategoryLayout& l = layouts[category];
+            const int top = std::bit_width(primary) - 1;
+            const int v = l.base + l.per_top * (12 - top)
+                + l.per_primary * (subsets_above(primary, RANKS, l.primary_k) - (l.skips_straights ? straights_above(primary) : 0))
+                + subsets_above(compress(kicker, primary), l.kicker_n, l.kicker_k);
+            return static_cast<unsigned short>(v);
+        }
+
+    } // namespace bitslice_detail
+
+    template<int Words>
+    class BitSlicedBlock {
+    public:
+        using Lanes = BitLanes<Words>;
+        static constexpr size_t LANES = 64 * static_cast<size_t>(Words);
+
+        // Transpose up to LANES hands of `cards` (5..7) ints each into card planes
+        void load(const int* hands, size_t count, int cards) noexcept
+        {
+            cards_ = {};
+            for (size_t j = 0; j < count; ++j) {
+                for (int k = 0; k < cards; ++k) {
+                    const int c = hands[j * cards + k];
+                    const int suit = std::countr_zero(static_cast<unsigned>(c) >> 12);
+                    cards_[suit * RANKS + RANK(c) - Deuce].set(j);
+                }
+            }
+        }
+
+        // Category and tie-break masks of every lane
+        void evaluate() noexcept
+        {
+            // Rank multiplicities: a 3-bit counter per rank over the four suits
+            Ranks present, pairs, trips, quads;
+            for (int r = 0; r < RANKS; ++r) {
+                Lanes n0, n1, n2;
+                for (int s = 0; s < 4; ++s) {
+                    const Lanes& x = cards_[s * RANKS + r];
+                    const Lanes carry = n0 & x;
+                    n0 ^= x;
+                    n2 |= n1 & carry;
+                    n1 ^= carry;
+                }
+                present[r] = n0 | n1 | n2;
+                pairs[r] = n1 & ~n0;
+                trips[r] = n1 & n0;
+                quads[r] = n2;
+            }
+
+            // Flush suit: a 3-bit counter per suit over the thirteen ranks, >= 5
+            Ranks flush;
+            Lanes has_flush;
+            for (int s = 0; s < 4; ++s) {
+                Lanes c0, c1, c2;
+                for (int r = 0; r < RANKS; ++r) {
+                    const Lanes& x = cards_[s * RANKS + r];
+                    const Lanes carry = c0 & x;
+                    c0 ^= x;
+                    c2 |= c1 & carry;
+                    c1 ^= carry;
+                }
+                const Lanes suited = c2 & (c0 | c1);
+                has_flush |= suited;
+                for (int r = 0; r < RANKS; ++r)
+                    flush[r] |= suited & cards_[s * RANKS + r];
+            }
+
+            Ranks sf_top, straight_top;
+            const Lanes has_sf = straight(flush, sf_top);
+            const Lanes has_straight = straight(present, straight_top);
+
+            Ranks quad_kicker, top_trips, fh_pair, flush5, trips_kickers, top_pairs, two_pair_kicker, pair_kickers, high5;
+            const Lanes has_quads = any(quads);
+            top<1>(without(present, quads), quad_kicker);
+            const Lanes has_trips = top<1>(trips, top_trips);
+            Ranks paired;
+            for (int r = 0; r < RANKS; ++r)
+                paired[r] = (trips[r] & ~top_trips[r]) | pairs[r];
+            const Lanes has_fh = has_trips & top<1>(paired, fh_pair);
+            top<5>(flush, flush5);
+            top<2>(without(present, top_trips), trips_kickers);
+            const Lanes has_two_pair = top<2>(pairs, top_pairs);
+            top<1>(without(present, top_pairs), two_pair_kicker);
+            const Lanes has_pair = any(pairs);
+            top<3>(without(present, pairs), pair_kickers);
+            top<5>(present, high5);
+
+            // Highest category wins
+            Lanes taken;
+            auto claim = [&](const Lanes& has) {
+                const Lanes mine = has & ~taken;
+                taken |= mine;
+                return mine;
+            };
+            const Lanes is_sf = claim(has_sf);
+            const Lanes is_quads = claim(has_quads);
+            const Lanes is_fh = claim(has_fh);
+            const Lanes is_flush = claim(has_flush);
+            const Lanes is_straight = claim(has_straight);
+            const Lanes is_trips = claim(has_trips);
+            const Lanes is_two_pair = claim(has_two_pair);
+            const Lanes is_pair = claim(has_pair);
+            const Lanes is_high = ~taken;
+            category_ = { is_sf, is_quads, is_fh, is_flush, is_straight, is_trips, is_two_pair, is_pair, is_high };
+
+            for (int r = 0; r < RANKS; ++r) {
+                primary_[r] = (is_sf & sf_top[r]) | (is_quads & quads[r]) | (is_fh & top_trips[r])
+                    | (is_flush & flush5[r]) | (is_straight & straight_top[r]) | (is_trips & top_trips[r])
+                    | (is_two_pair & top_pairs[r]) | (is_pair & pairs[r]) | (is_high & high5[r]);
+                kicker_[r] = (is_quads & quad_kicker[r]) | (is_fh & fh_pair[r]) | (is_trips & trips_kickers[r])
+                    | (is_two_pair & two_pair_kicker[r]) | (is_pair & pair_kickers[r]);
+            }
+        }
+
+        // Transpose the first `count` lanes back and write their Cactus Kev values
+        void store(unsigned short* out, size_t count) const noexcept
+        {
+            // 32 planes per lane, eight lanes by eight planes at a time:
+            // primary ranks, category bits 0-2, kicker ranks, category bit 3
+            std::array<Lanes, 4> category_bits;
+            for (int c = 0; c < 9; ++c)
+                for (int b = 0; b < 4; ++b)
+                    if ((c + 1) >> b & 1) category_bits[b] |= category_[c];
+
+            static constexpr Lanes none{};
+            std::array<const Lanes*, 32> planes;
+            for (int r = 0; r < RANKS; ++r) {
+                planes[r] = &primary_[r];
+                planes[16 + r] = &kicker_[r];
+            }
+            planes[13] = &category_bits[0];
+            planes[14] = &category_bits[1];
+            planes[15] = &category_bits[2];
+            planes[29] = &category_bits[3];
+            planes[30] = planes[31] = &none;
+
+            std::array<uint32_t, LANES> lanes{};
+            for (int w = 0; w < Words; ++w) {
+                for (int g = 0; g < 8; ++g) {
+                    for (int o = 0; o < 4; ++o) {
+                        uint64_t x = 0;
+                        for (int i = 0; i < 8; ++i)
+                            x |= (planes[o * 8 + i]->w[w] >> (8 * g) & 0xFF) << (8 * i);
+                        x = transpose8(x);
+                        for (int j = 0; j < 8; ++j)
+                            lanes[w * 64 + g * 8 + j] |= static_cast<uint32_t>(x >> (8 * j) & 0xFF) << (8 * o);
+                    }
+                }
+            }
+
+            for (size_t j = 0; j < count; ++j) {
+                const uint32_t v = lanes[j];
+                const int category = static_cast<int>((v >> 13 & 7) | (v >> 26 & 8));
+                out[j] = bitslice_detail::kev_value(category, v & 0x1FFF, v >> 16 & 0x1FFF);
+            }
+        }
+
+    private:
+        static constexpr int RANKS = bitslice_detail::RANKS;
+        using Ranks = std::array<Lanes, RANKS>;
+
+        [[nodiscard]] static Lanes any(const Ranks& m) noexcept
+        {
+            Lanes a;
+            for (const Lanes& x : m) a |= x;
+            return a;
+        }
+
+        [[nodiscard]] static Ranks without(const Ranks& m, const Ranks& drop) noexcept
+        {
+            Ranks out;
+            for (int r = 0; r < RANKS; ++r) out[r] = m[r] & ~drop[r];
+            return out;
+        }
+
+        // The highest K ranks of m, found with a thermometer counter
+        // (seen[i]: more than i ranks taken). Returns the lanes that had K.
+        template<int K>
+        static Lanes top(const Ranks& m, Ranks& out) noexcept
+        {
+            std::array<Lanes, K> seen{};
+            for (int r = RANKS - 1; r >= 0; --r) {
+                const Lanes take = m[r] & ~seen[K - 1];
+                out[r] = take;
+                for (int i = K - 1; i > 0; --i)
+                    seen[i] |= seen[i - 1] & take;
+                seen[0] |= take;
+            }
+            return seen[K - 1];
+        }
+
+        // Transpose an 8x8 bit matrix held one row per byte
+        [[nodiscard]] static constexpr uint64_t transpose8(uint64_t x) noexcept
+        {
+            uint64_t t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+            x ^= t ^ (t << 7);
+            t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+            x ^= t ^ (t << 14);
+            t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+            x ^= t ^ (t << 28);
+            return x;
+        }
+
+        // Highest straight in m as its top rank (the five, rank 3, for a
+        // wheel). Returns the lanes that have one.
+        static Lanes straight(const Ranks& m, Ranks& top) noexcept
+        {
+            Lanes found;
+            top = {};
+            for (int t = RANKS - 1; t >= 4; --t) {
+                const Lanes s = m[t] & m[t - 1] & m[t - 2] & m[t - 3] & m[t - 4];
+                top[t] = s & ~found;
+                found |= s;
+            }
+            const Lanes wheel = m[12] & m[0] & m[1] & m[2] & m[3];
+            top[3] = wheel & ~found;
+            return found | wheel;
+        }
+
+        std::array<Lanes, 52> cards_{};         // suit * 13 + rank - Deuce
+        std::array<Lanes, 9> category_{};       // one-hot, HandRank - 1
+        Ranks primary_{}, kicker_{};
+    };
+
+    // Evaluate `count` hands of `cards` (5..7) ints stored back to back
+    template<int Words = 1>
+    void eval_bitsliced(const int* hands, size_t count, int cards, unsigned short* out) noexcept
+    {
+        BitSlicedBlock<Words> block;
+        constexpr size_t LANES = BitSlicedBlock<Words>::LANES;
+        for (size_t b = 0; b < count; b += LANES) {
+            const size_t n = count - b < LANES ? count - b : LANES;
+            block.load(hands + b * cards, n, cards);
+            block.evaluate();
+            block.store(out + b, n);
+        }
+    }
+
+} // namespace poker
@@ -0,0 +1,258 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "HugePages.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+/****************************************************************
+    Reusable batch buffers
+
+    A fresh buffer costs a page fault per 4 KB the first time it is
+    touched, and the kernel zeroes every one of those pages. For a
+    benchmark config of 500M hands that is more time than the
+    evaluation takes. A new std::vector also zero-fills it again.
+
+    BufferPool keeps released buffers mapped and hands them out
+    again:
+
+        BufferPool::Lease a = pool.acquire(bytes, HugePages::Off);
+        ... use a.data() ...
+        // a's destructor returns the buffer to the pool
+
+    Memory from a lease is page-aligned and uninitialised. A reused
+    buffer still holds whatever the last lease wrote into it. An
+    idle buffer is handed out again for a request with the same
+    HugePages setting that needs at least half of it, so a small
+    request cannot hold on to a large buffer. On a miss, the pool
+    unmaps its idle buffers before it maps a new one, so a sweep of
+    growing sizes keeps only one generation mapped.
+
+    buffer_pool() is the process-wide pool used by the benchmark's
+    HandSet and by PooledArray. ProcessUsage reads peak resident
+    memory and page-fault counts, so a run can show what the pool
+    saved.
+****************************************************************/
+
+namespace poker {
+
+    // Peak resident memory and page faults of the whole process so far
+    struct ProcessUsage {
+        uint64_t peak_rss_bytes = 0;
+        uint64_t minor_faults = 0;     // Windows counts every fault here
+        uint64_t major_faults = 0;     // faults that read from disk
+
+        [[nodiscard]] static ProcessUsage now() noexcept
+        {
+            ProcessUsage u;
+#ifdef _WIN32
+            PROCESS_MEMORY_COUNTERS c{};
+            if (GetProcessMemoryInfo(GetCurrentProcess(), &c, sizeof(c))) {
+                u.peak_rss_bytes = c.PeakWorkingSetSize;
+                u.minor_faults = c.PageFaultCount;
+            }
+#else
+            rusage r{};
+            if (getrusage(RUSAGE_SELF, &r) == 0) {
+                // ru_maxrss is in kilobytes on Linux, bytes on macOS
+#ifdef __APPLE__
+                u.peak_rss_bytes = static_cast<uint64_t>(r.ru_maxrss);
+#else
+                u.peak_rss_bytes = static_cast<uint64_t>(r.ru_maxrss) * 1024;
+#endif
+                u.minor_faults = static_cast<uint64_t>(r.ru_minflt);
+                u.major_faults = static_cast<uint64_t>(r.ru_majflt);
+            }
+#endif
+            return u;
+        }
+
+        [[nodiscard]] uint64_t page_faults() const noexcept { return minor_faults + major_faults; }
+
+        // Faults between two snapshots; the peak is the later one's
+        [[nodiscard]] ProcessUsage operator-(const ProcessUsage& before) const noexcept
+        {
+            return { peak_rss_bytes, minor_faults - before.minor_faults, major_faults - before.major_faults };
+        }
+    };
+
+    class BufferPool {
+    public:
+        struct Stats {
+            uint64_t leases = 0;            // acquire() calls
+            uint64_t reused = 0;            // of which served by an idle buffer
+            size_t mapped_bytes = 0;        // leased and idle
+            size_t peak_mapped_bytes = 0;
+        };
+
+        // A buffer on loan from the pool; returned when destroyed
+        class Lease {
+        public:
+            Lease() = default;
+            Lease(Lease&& o) noexcept
+                : pool_(std::exchange(o.pool_, nullptr)), buffer_(std::move(o.buffer_)),
+                  pages_(o.pages_), bytes_(std::exchange(o.bytes_, 0)) {}
+            Lease& operator=(Lease&& o) noexcept
+            {
+                if (this != &o) {
+                    give_back();
+                    pool_ = std::exchange(o.pool_, nullptr);
+                    buffer_ = std::move(o.buffer_);
+                    pages_ = o.pages_;
+                    bytes_ = std::exchange(o.bytes_, 0);
+                }
+                return *this;
+            }
+            Lease(const Lease&) = delete;
+            Lease& operator=(const Lease&) = delete;
+            ~Lease() { give_back(); }
+
+            [[nodiscard]] void* data() const noexcept { return buffer_.data(); }
+            [[nodiscard]] size_t size() const noexcept { return bytes_; }     // as requested
+            [[nodiscard]] const PageBuffer& buffer() const noexcept { return buffer_; }
+
+        private:
+            friend class BufferPool;
+            Lease(BufferPool* pool, PageBuffer buffer, HugePages pages, size_t bytes) noexcept
+                : pool_(pool), buffer_(std::move(buffer)), pages_(pages), bytes_(bytes) {}
+
+            void give_back() noexcept
+            {
+                if (pool_ && buffer_.data()) pool_->release(std::move(buffer_), pages_);
+                pool_ = nullptr;
+                bytes_ = 0;
+            }
+
+            BufferPool* pool_ = nullptr;
+            PageBuffer buffer_;
+            HugePages pages_ = HugePages::Off;
+            size_t bytes_ = 0;
+        };
+
+        BufferPool() = default;
+        BufferPool(const BufferPool&) = delete;
+        BufferPool& operator=(const BufferPool&) = delete;
+
+        // At least `bytes` of page-aligned, uninitialised memory. Throws
+        // std::bad_alloc when a new buffer cannot be mapped.
+        [[nodiscard]] Lease acquire(size_t bytes, HugePages pages = HugePages::Off)
+        {
+            std::unique_lock lock(mutex_);
+            ++stats_.leases;
+            auto best = idle_.end();
+            for (auto it = idle_.begin(); it != idle_.end(); ++it) {
+                const size_t size = it->buffer.size();
+                if (it->pages == pages && size >= bytes && size / 2 <= bytes
+                    && (best == idle_.end() || size < best->buffer.size()))
+                    best = it;
+            }
+            if (best != idle_.end()) {
+                PageBuffer buffer = std::move(best->buffer);
+                idle_.erase(best);
+                ++stats_.reused;
+                return Lease(this, std::move(buffer), pages, bytes);
+            }
+
+            std::vector<Idle> unmap = std::exchange(idle_, {});
+            for (const Idle& i : unmap) stats_.mapped_bytes -= i.buffer.size();
+            lock.unlock();
+            unmap.clear();
+
+            PageBuffer buffer(bytes, pages);
+            lock.lock();
+            stats_.mapped_bytes += buffer.size();
+            stats_.peak_mapped_bytes = std::max(stats_.peak_mapped_bytes, stats_.mapped_bytes);
+            return Lease(this, std::move(buffer), pages, bytes);
+        }
+
+        // Unmap every idle buffer
+        void trim()
+        {
+            std::vector<Idle> unmap;
+            {
+                std::lock_guard lock(mutex_);
+                unmap = std::exchange(idle_, {});
+                for (const Idle& i : unmap) stats_.mapped_bytes -= i.buffer.size();
+            }
+        }
+
+        [[nodiscard]] Stats stats() const
+        {
+            std::lock_guard lock(mutex_);
+            return stats_;
+        }
+
+    private:
+        struct Idle {
+            PageBuffer buffer;
+            HugePages pages;
+        };
+
+        void release(PageBuffer&& buffer, HugePages pages) noexcept
+        {
+            const size_t size = buffer.size();
+            std::lock_guard lock(mutex_);
+            try {
+                idle_.push_back({ std::move(buffer), pages });
+            }
+            catch (...) {
+                // No room to keep it: it unmaps
+                stats_.mapped_bytes -= size;
+            }
+        }
+
+        mutable std::mutex mutex_;
+        std::vector<Idle> idle_;
+        Stats stats_;
+    };
+
+    // The process-wide pool
+    [[nodiscard]] inline BufferPool& buffer_pool()
+    {
+        static BufferPool pool;
+        return pool;
+    }
+
+    // `count` uninitialised Ts in a pooled buffer: a std::vector
+    // replacement for per-run result and scratch arrays
+    template<typename T>
+    class PooledArray {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>);
+    public:
+        PooledArray() = default;
+        explicit PooledArray(size_t count, HugePages pages = HugePages::Off, BufferPool& pool = buffer_pool())
+            : lease_(pool.acquire(std::max<size_t>(count, 1) * sizeof(T), pages)), count_(count) {}
+
+        [[nodiscard]] size_t size() const noexcept { return count_; }
+        [[nodiscard]] T* data() noexcept { return static_cast<T*>(lease_.data()); }
+        [[nodiscard]] const T* data() const noexcept { return static_cast<const T*>(lease_.data()); }
+        [[nodiscard]] T& operator[](size_t i) noexcept { return data()[i]; }
+        [[nodiscard]] const T& operator[](size_t i) const noexcept { return data()[i]; }
+        [[nodiscard]] T* begin() noexcept { return data(); }
+        [[nodiscard]] T* end() noexcept { return data() + count_; }
+        [[nodiscard]] const T* begin() const noexcept { return data(); }
+        [[nodiscard]] const T* end() const noexcept { return data() + count_; }
+        [[nodiscard]] std::span<T> span() noexcept { return { data(), count_ }; }
+        [[nodiscard]] std::span<const T> span() const noexcept { return { data(), count_ }; }
+
+    private:
+        BufferPool::Lease lease_;
+        size_t count_ = 0;
+    };
+
+} // namespace poker
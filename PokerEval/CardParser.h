@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "Poker.h"
+
+/****************************************************************
+    Zero-copy card text scanner
+
+    Reads cards written the way print_hand emits them ("Ac 4d 7c
+    Jh 2s") straight out of a buffer, without building strings.
+    Rank and suit characters go through 256-entry lookup tables,
+    so one card costs two loads and one table index: deck order is
+    suit * 13 + rank, matching init_deck().
+****************************************************************/
+
+namespace poker {
+
+    inline constexpr uint8_t NOT_A_CARD = 0xFF;
+
+    namespace parser_detail {
+
+        constexpr std::array<uint8_t, 256> make_rank_lut() noexcept
+        {
+            std::array<uint8_t, 256> lut{};
+            lut.fill(NOT_A_CARD);
+            constexpr std::string_view ranks = "23456789TJQKA";
+            for (uint8_t i = 0; i < ranks.size(); ++i) {
+                lut[static_cast<unsigned char>(ranks[i])] = i;
+                if (ranks[i] >= 'A')
+                    lut[static_cast<unsigned char>(ranks[i] + ('a' - 'A'))] = i;
+            }
+            return lut;
+        }
+
+        constexpr std::array<uint8_t, 256> make_suit_lut() noexcept
+        {
+            std::array<uint8_t, 256> lut{};
+            lut.fill(NOT_A_CARD);
+            constexpr std::string_view suits = "cdhs";
+            for (uint8_t i = 0; i < suits.size(); ++i) {
+                lut[static_cast<unsigned char>(suits[i])] = i;
+                lut[static_cast<unsigned char>(suits[i] - ('a' - 'A'))] = i;
+            }
+            return lut;
+        }
+
+    } // namespace parser_detail
+
+    inline constexpr std::array<uint8_t, 256> rank_lut = parser_detail::make_rank_lut();
+    inline constexpr std::array<uint8_t, 256> suit_lut = parser_detail::make_suit_lut();
+
+    // The deck in Cactus Kev encoding, indexed by suit * 13 + rank.
+    inline constexpr Deck card_table = init_deck();
+
+    // Deck index (0..51) of the two-character card at p, or NOT_A_CARD.
+    [[nodiscard]] constexpr uint8_t parse_card_index(const char* p) noexcept
+    {
+        const uint8_t r = rank_lut[static_cast<unsigned char>(p[0])];
+        const uint8_t s = suit_lut[static_cast<unsigned char>(p[1])];
+        return (r > 12 || s > 3) ? NOT_A_CARD : static_cast<uint8_t>(s * 13 + r);
+    }
+
+    // Cactus Kev card for the two characters at p, or -1.
+    [[nodiscard]] constexpr int parse_card(const char* p) noexcept
+    {
+        const uint8_t i = parse_card_index(p);
+        return i == NOT_A_CARD ? -1 : card_table[i];
+    }
+
+    [[nodiscard]] constexpr bool is_blank(char c) noexcept
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == ',';
+    }
+
+    // Parse whitespace-separated cards from [p, end) into out (at most max_cards).
+    // Returns the number parsed, or -1 on a malformed token, a repeated card
+    // or too many cards.
+    [[nodiscard]] constexpr int parse_cards(const char* p, const char* end, int* out, int max_cards) noexcept
+    {
+        int n = 0;
+        uint64_t seen = 0;
+        for (;;) {
+            while (p < end && is_blank(*p)) ++p;
+            if (p == end) return n;
+            if (end - p < 2 || n == max_cards) return -1;
+            const uint8_t index = parse_card_index(p);
+            if (index == NOT_A_CARD) return -1;
+            if (p + 2 < end && !is_blank(p[2])) return -1;
+            const uint64_t bit = uint64_t{ 1 } << index;
+            if (seen & bit) return -1;
+            seen |= bit;
+            out[n++] = card_table[index];
+            p += 2;
+        }
+    }
+
+} // namespace poker
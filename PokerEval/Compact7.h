@@ -0,0 +1,173 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include "Poker.h"
+
+/****************************************************************
+    Small-footprint 7-card evaluator
+
+    eval_7hand looks up 21 five-card subsets. Table7 makes it one
+    load, but from a 267 MB table that evicts everything that
+    shares the caches. eval_7cards_compact makes it one lookup in
+    tables that fit in L2:
+
+        flush7        8,192 x uint16_t   16 KB   best flush or
+                                                 straight flush of
+                                                 a suit's rank bits
+        rank_values  49,205 x uint16_t   96 KB   best hand of every
+                                                 rank pattern
+        offsets                           1 KB   perfect hash
+
+    When no suit holds five cards, the value depends only on how
+    many cards of each rank the hand holds, at most 4 of each.
+    There are 49,205 such patterns of seven cards. The hash numbers
+    them densely: it walks the ranks from the ace down and adds,
+    for each rank, the count of patterns that hold fewer of that
+    rank and agree on every rank above it. Each term is one load
+    from `offsets`.
+
+    Suits are counted in four 4-bit fields at once; adding 3 to
+    each field sets its top bit exactly when a suit holds five or
+    more, and only then is the flush suit's rank mask built.
+****************************************************************/
+
+namespace poker {
+
+    namespace compact7_detail {
+
+        // ways[n][k]: patterns of k cards over n ranks, at most 4 of each
+        inline constexpr auto ways = [] {
+            std::array<std::array<uint32_t, 8>, 14> w{};
+            w[0][0] = 1;
+            for (int n = 1; n <= 13; ++n)
+                for (int k = 0; k <= 7; ++k)
+                    for (int c = 0; c <= std::min(4, k); ++c)
+                        w[n][k] += w[n - 1][k - c];
+            return w;
+        }();
+
+        inline constexpr uint32_t RANK_PATTERNS = ways[13][7];
+        static_assert(RANK_PATTERNS == 49'205);
+
+        // offsets[r][k][q]: hash contribution of rank r (0 = deuce) holding q
+        // of the k cards not yet placed on higher ranks
+        inline constexpr auto offsets = [] {
+            std::array<std::array<std::array<uint16_t, 5>, 8>, 13> o{};
+            for (int r = 0; r < 13; ++r)
+                for (int k = 0; k <= 7; ++k)
+                    for (int q = 1; q <= std::min(4, k); ++q)
+                        o[r][k][q] = static_cast<uint16_t>(o[r][k][q - 1] + ways[r][k - (q - 1)]);
+            return o;
+        }();
+
+        // One 4-bit count per suit, indexed by the suit bits (card >> 12) & 0xF
+        inline constexpr auto suit_count = [] {
+            std::array<uint16_t, 16> s{};
+            for (int i = 0; i < 4; ++i)
+                s[1 << i] = static_cast<uint16_t>(1 << (4 * i));
+            return s;
+        }();
+
+        // Index of the pattern with counts[r] cards of rank r; packed, four
+        // bits per rank with the deuce lowest. All 13 ranks are visited:
+        // stopping once k reaches 0 is a branch random hands mispredict.
+        [[nodiscard]] constexpr uint32_t pattern_index(uint64_t counts) noexcept
+        {
+            uint32_t index = 0;
+            int k = 7;
+            for (int r = 12; r >= 0; --r) {
+                const int q = static_cast<int>(counts >> (4 * r)) & 0xF;
+                index += offsets[r][k][q];
+                k -= q;
+            }
+            return index;
+        }
+
+        struct Tables {
+            std::array<uint16_t, 8192> flush7{};
+            std::array<uint16_t, RANK_PATTERNS> rank_values{};
+        };
+
+        // Fill rank_values for every pattern that places the remaining k
+        // cards on ranks r and below. A representative hand deals its cards
+        // to the suits in turn, so no suit gets more than two.
+        inline void fill_patterns(Tables& t, std::array<uint8_t, 13>& counts, int r, int k)
+        {
+            if (r < 0) {
+                if (k != 0) return;
+                std::array<int, 7> hand;
+                int n = 0;
+                for (int rank = 0; rank < 13; ++rank)
+                    for (int c = 0; c < counts[rank]; ++c, ++n)
+                        hand[n] = primes[rank] | ((Deuce + rank) << 8) | (CLUB >> (n % 4)) | (1 << (16 + rank));
+                uint64_t packed = 0;
+                for (int rank = 0; rank < 13; ++rank)
+                    packed |= uint64_t{ counts[rank] } << (4 * rank);
+                t.rank_values[pattern_index(packed)] = eval_7hand(hand);
+                return;
+            }
+            for (int q = 0; q <= std::min(4, k); ++q) {
+                counts[r] = static_cast<uint8_t>(q);
+                fill_patterns(t, counts, r - 1, k - q);
+            }
+            counts[r] = 0;
+        }
+
+        [[nodiscard]] inline Tables build()
+        {
+            Tables t;
+            // Five bits: the flushes table. Six or seven: drop each bit in turn;
+            // every smaller mask is numerically smaller, so it is done already.
+            for (uint32_t mask = 0; mask < t.flush7.size(); ++mask) {
+                const int bits = std::popcount(mask);
+                if (bits == 5) {
+                    t.flush7[mask] = flushes[mask];
+                } else if (bits > 5) {
+                    uint16_t best = 9999;
+                    for (uint32_t m = mask; m; m &= m - 1)
+                        best = std::min(best, t.flush7[mask & ~(m & (~m + 1))]);
+                    t.flush7[mask] = best;
+                }
+            }
+            std::array<uint8_t, 13> counts{};
+            fill_patterns(t, counts, 12, 7);
+            return t;
+        }
+
+    } // namespace compact7_detail
+
+    inline const compact7_detail::Tables compact7_tables = compact7_detail::build();
+
+    // Bytes of table data eval_7cards_compact reads
+    inline constexpr size_t COMPACT7_TABLE_BYTES = sizeof(compact7_detail::Tables) + sizeof(compact7_detail::offsets);
+
+    // Value of seven distinct Cactus Kev cards, as eval_7hand would give
+    [[nodiscard]] inline unsigned short eval_7cards_compact(const int* h) noexcept
+    {
+        using namespace compact7_detail;
+        uint32_t suits = 0;
+        uint64_t counts = 0;        // 4 bits per rank, deuce lowest
+        for (int k = 0; k < 7; ++k) {
+            suits += suit_count[(h[k] >> 12) & 0xF];
+            counts += uint64_t{ 1 } << (4 * (((h[k] >> 8) & 0xF) - Deuce));
+        }
+
+        if (const uint32_t flush = (suits + 0x3333) & 0x8888) {
+            const int suit = 0x1000 << (std::countr_zero(flush) >> 2);
+            uint32_t mask = 0;
+            for (int k = 0; k < 7; ++k)
+                if (h[k] & suit) mask |= static_cast<uint32_t>(h[k]) >> 16;
+            return compact7_tables.flush7[mask];
+        }
+        return compact7_tables.rank_values[pattern_index(counts)];
+    }
+
+    [[nodiscard]] inline unsigned short eval_7hand_compact(Hand hand) noexcept
+    {
+        return eval_7cards_compact(hand.data());
+    }
+
+} // namespace poker
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include "Poker.h"
+#include "Showdown.h"
+
+/****************************************************************
+    Hold'em equity
+
+    Given every player's hole cards and 0-5 known board cards,
+    deals out the rest of the board and credits each board's pot
+    to its winners (split evenly on ties). A player's equity is
+    their average share of the pot.
+
+    With max_boards == 0, or when there are no more than max_boards
+    possible run-outs, every run-out is enumerated and the result
+    is exact. Otherwise max_boards run-outs are sampled from an
+    mt19937_64 seeded with `seed`, so results are repeatable. The
+    largest exact case, heads-up preflop, is C(48,5) = 1,712,304
+    boards.
+****************************************************************/
+
+namespace poker {
+
+    struct EquityResult {
+        std::array<double, MAX_SEATS> equity{};
+        uint64_t boards = 0;     // run-outs evaluated
+        bool exact = true;       // every run-out was enumerated
+    };
+
+    namespace equity_detail {
+
+        [[nodiscard]] constexpr uint64_t choose(int n, int k) noexcept
+        {
+            if (k < 0 || k > n) return 0;
+            uint64_t r = 1;
+            for (int i = 1; i <= k; ++i)
+                r = r * static_cast<uint64_t>(n - k + i) / static_cast<uint64_t>(i);
+            return r;
+        }
+
+        // Deck index (suit * 13 + rank) of a Cactus Kev card.
+        [[nodiscard]] constexpr int deck_index(int card) noexcept
+        {
+            const int suit = (card & CLUB) ? 0 : (card & DIAMOND) ? 1 : (card & HEART) ? 2 : 3;
+            return suit * 13 + RANK(card) - Deuce;
+        }
+
+        // Score one complete board: add each winner's share of the pot.
+        inline void score_board(const Showdown& s, std::array<int, 7>& hand, std::array<double, MAX_SEATS>& share) noexcept
+        {
+            std::array<unsigned short, MAX_SEATS> values;
+            unsigned short best = 9999;
+            for (int p = 0; p < s.players; ++p) {
+                hand[5] = s.holes[p][0];
+                hand[6] = s.holes[p][1];
+                values[p] = eval_7hand(hand);
+                best = std::min(best, values[p]);
+            }
+            int winners = 0;
+            for (int p = 0; p < s.players; ++p)
+                winners += (values[p] == best);
+            const double split = 1.0 / winners;
+            for (int p = 0; p < s.players; ++p)
+                if (values[p] == best) share[p] += split;
+        }
+
+    } // namespace equity_detail
+
+    // Equity of each of s.players hands, with s.board[0..board_cards) already dealt.
+    // Throws std::invalid_argument for bad player/board counts or repeated cards.
+    [[nodiscard]] inline EquityResult evaluate_equity(const Showdown& s, int board_cards,
+        uint64_t max_boards = 0, uint64_t seed = 1)
+    {
+        using namespace equity_detail;
+
+        if (s.players < 1 || s.players > MAX_SEATS || board_cards < 0 || board_cards > 5)
+            throw std::invalid_argument("evaluate_equity: need 1..10 players and 0..5 board cards");
+
+        uint64_t dead = 0;
+        auto mark = [&dead](int card) {
+            const uint64_t bit = uint64_t{ 1 } << deck_index(card);
+            if (dead & bit) throw std::invalid_argument("evaluate_equity: repeated card");
+            dead |= bit;
+        };
+        for (int i = 0; i < board_cards; ++i) mark(s.board[i]);
+        for (int p = 0; p < s.players; ++p) {
+            mark(s.holes[p][0]);
+            mark(s.holes[p][1]);
+        }
+
+        static constexpr Deck deck = init_deck();
+        std::array<int, 52> live;
+        int n = 0;
+        for (int i = 0; i < 52; ++i)
+            if (!(dead >> i & 1)) live[n++] = deck[i];
+
+        const int missing = 5 - board_cards;
+        const uint64_t total = choose(n, missing);
+
+        EquityResult result;
+        std::array<double, MAX_SEATS> share{};
+        std::array<int, 7> hand;
+        std::copy(s.board.begin(), s.board.begin() + board_cards, hand.begin());
+
+        if (max_boards == 0 || total <= max_boards) {
+            // Walk every missing-card combination of the live cards in colex order
+            std::array<int, 5> idx;
+            for (int i = 0; i < missing; ++i) idx[i] = i;
+            for (uint64_t b = 0; b < total; ++b) {
+                for (int i = 0; i < missing; ++i) hand[board_cards + i] = live[idx[i]];
+                score_board(s, hand, share);
+
+                int i = 0;
+                while (i < missing - 1 && idx[i] + 1 == idx[i + 1]) {
+                    idx[i] = i;
+                    ++i;
+                }
+                if (missing) ++idx[i];
+            }
+            result.boards = total;
+        } else {
+            std::mt19937_64 gen(seed);
+            for (uint64_t b = 0; b < max_boards; ++b) {
+                for (int i = 0; i < missing; ++i) {
+                    std::swap(live[i], live[i + static_cast<int>(gen() % static_cast<uint64_t>(n - i))]);
+                    hand[board_cards + i] = live[i];
+                }
+                score_board(s, hand, share);
+            }
+            result.boards = max_boards;
+            result.exact = false;
+        }
+
+        for (int p = 0; p < s.players; ++p)
+            result.equity[p] = share[p] / static_cast<double>(result.boards);
+        return result;
+    }
+
+} // namespace poker
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <print>
+#include <vector>
+#include "Poker.h"
+
+/****************************************************************
+    Hot-path counters for eval_5cards / eval_7hand
+
+    Pass EvalCounters as the instrumentation policy to count which
+    path every evaluation takes and which table cache lines it
+    reads:
+
+        v = eval_7hand<EvalCounters>(hand);
+        ...
+        EvalCounterData d = EvalCounters::snapshot();  // all threads
+        print_counters(stdout, d);
+
+    Every thread counts into its own thread_local block, so the hot
+    path never shares a cache line; blocks register themselves so
+    snapshot() can merge them, and a thread's counts are kept when
+    it exits. A snapshot taken while evaluations are running is
+    approximate. The default policy, NoCounters, costs nothing.
+****************************************************************/
+
+namespace poker {
+
+    // 64-byte lines of a uint16_t lookup table of up to 8192 entries
+    inline constexpr int TABLE_LINES = 256;
+    inline constexpr int ENTRIES_PER_LINE = 32;
+
+    // Merged counts, plain values for reporting and merging
+    struct EvalCounterData {
+        uint64_t flush = 0;             // flushes[qbits]: flush or straight flush
+        uint64_t unique5 = 0;           // unique5[qbits]: straight or high card
+        uint64_t hash = 0;              // prime-product hash
+        uint64_t hands7 = 0;            // eval_7hand calls
+        uint64_t early_exit7 = 0;       // of which best == 1 returned early
+        uint64_t subsets7 = 0;          // five-card subsets eval_7hand evaluated
+        std::array<uint64_t, TABLE_LINES> flush_lines{};
+        std::array<uint64_t, TABLE_LINES> unique5_lines{};
+        std::array<uint64_t, TABLE_LINES> hash_lines{};
+
+        [[nodiscard]] uint64_t calls5() const noexcept { return flush + unique5 + hash; }
+
+        EvalCounterData& merge(const EvalCounterData& o) noexcept
+        {
+            flush += o.flush;
+            unique5 += o.unique5;
+            hash += o.hash;
+            hands7 += o.hands7;
+            early_exit7 += o.early_exit7;
+            subsets7 += o.subsets7;
+            for (int i = 0; i < TABLE_LINES; ++i) {
+                flush_lines[i] += o.flush_lines[i];
+                unique5_lines[i] += o.unique5_lines[i];
+                hash_lines[i] += o.hash_lines[i];
+            }
+            return *this;
+        }
+    };
+
+    class EvalCounters {
+    public:
+        static void on_flush(uint32_t qbits) noexcept
+        {
+            Block& b = local();
+            bump(b.flush);
+            bump(b.flush_lines[qbits / ENTRIES_PER_LINE]);
+        }
+
+        static void on_unique5(uint32_t qbits) noexcept
+        {
+            Block& b = local();
+            bump(b.unique5);
+            bump(b.unique5_lines[qbits / ENTRIES_PER_LINE]);
+        }
+
+        static void on_hash(unsigned index) noexcept
+        {
+            Block& b = local();
+            bump(b.hash);
+            bump(b.hash_lines[(index / ENTRIES_PER_LINE) % TABLE_LINES]);
+        }
+
+        static void on_7hand(int evaluated, bool early_exit) noexcept
+        {
+            Block& b = local();
+            bump(b.hands7);
+            bump(b.subsets7, static_cast<uint64_t>(evaluated));
+            if (early_exit) bump(b.early_exit7);
+        }
+
+        // Counts of every thread, live or exited, since the last reset()
+        [[nodiscard]] static EvalCounterData snapshot()
+        {
+            Registry& r = registry();
+            std::lock_guard lock(r.mutex);
+            EvalCounterData d = r.retired;
+            for (const Block* b : r.live)
+                d.merge(b->load());
+            return d;
+        }
+
+        // Zero every thread's counts. Call while no instrumented evaluation runs.
+        static void reset()
+        {
+            Registry& r = registry();
+            std::lock_guard lock(r.mutex);
+            r.retired = {};
+            for (Block* b : r.live)
+                b->clear();
+        }
+
+    private:
+        using Counter = std::atomic<uint64_t>;
+
+        // Only the owning thread writes, so a relaxed load + store is
+        // enough and compiles to a plain increment.
+        static void bump(Counter& c, uint64_t n = 1) noexcept
+        {
+            c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        struct Block;
+
+        struct Registry {
+            std::mutex mutex;
+            std::vector<Block*> live;
+            EvalCounterData retired;
+        };
+
+        static Registry& registry()
+        {
+            static Registry r;
+            return r;
+        }
+
+        struct alignas(64) Block {
+            Counter flush{ 0 }, unique5{ 0 }, hash{ 0 };
+            Counter hands7{ 0 }, early_exit7{ 0 }, subsets7{ 0 };
+            std::array<Counter, TABLE_LINES> flush_lines{};
+            std::array<Counter, TABLE_LINES> unique5_lines{};
+            std::array<Counter, TABLE_LINES> hash_lines{};
+
+            Block()
+            {
+                Registry& r = registry();
+                std::lock_guard lock(r.mutex);
+                r.live.push_back(this);
+            }
+
+            ~Block()
+            {
+                Registry& r = registry();
+                std::lock_guard lock(r.mutex);
+                r.retired.merge(load());
+                r.live.erase(std::find(r.live.begin(), r.live.end(), this));
+            }
+
+            [[nodiscard]] EvalCounterData load() const noexcept
+            {
+                constexpr auto relaxed = std::memory_order_relaxed;
+                EvalCounterData d;
+                d.flush = flush.load(relaxed);
+                d.unique5 = unique5.load(relaxed);
+                d.hash = hash.load(relaxed);
+                d.hands7 = hands7.load(relaxed);
+                d.early_exit7 = early_exit7.load(relaxed);
+                d.subsets7 = subsets7.load(relaxed);
+                for (int i = 0; i < TABLE_LINES; ++i) {
+                    d.flush_lines[i] = flush_lines[i].load(relaxed);
+                    d.unique5_lines[i] = unique5_lines[i].load(relaxed);
+                    d.hash_lines[i] = hash_lines[i].load(relaxed);
+                }
+                return d;
+            }
+
+            void clear() noexcept
+            {
+                constexpr auto relaxed = std::memory_order_relaxed;
+                for (Counter* c : { &flush, &unique5, &hash, &hands7, &early_exit7, &subsets7 })
+                    c->store(0, relaxed);
+                for (int i = 0; i < TABLE_LINES; ++i) {
+                    flush_lines[i].store(0, relaxed);
+                    unique5_lines[i].store(0, relaxed);
+                    hash_lines[i].store(0, relaxed);
+                }
+            }
+        };
+
+        static Block& local() noexcept
+        {
+            thread_local Block block;
+            return block;
+        }
+    };
+
+    // Print path shares, eval_7hand early exits and, per table, how many
+    // cache lines were touched and how many lines cover 90% of the reads.
+    inline void print_counters(std::FILE* f, const EvalCounterData& d)
+    {
+        const uint64_t calls = d.calls5();
+        auto pct = [](uint64_t n, uint64_t total) { return total ? n * 100.0 / total : 0.0; };
+
+        std::println(f, "  eval_5cards calls: {:L}", calls);
+        std::println(f, "    {:<34s} {:14L} ({:6.2f}%)", "unique5 (straight / high card)", d.unique5, pct(d.unique5, calls));
+        std::println(f, "    {:<34s} {:14L} ({:6.2f}%)", "flushes (flush / straight flush)", d.flush, pct(d.flush, calls));
+        std::println(f, "    {:<34s} {:14L} ({:6.2f}%)", "prime hash", d.hash, pct(d.hash, calls));
+
+        if (d.hands7) {
+            std::println(f, "  eval_7hand calls: {:L}", d.hands7);
+            std::println(f, "    {:<34s} {:14L} ({:6.2f}%)", "best == 1 early exit", d.early_exit7, pct(d.early_exit7, d.hands7));
+            std::println(f, "    {:<34s} {:14.2f}", "five-card subsets per hand", static_cast<double>(d.subsets7) / d.hands7);
+        }
+
+        auto lines = [&](const char* name, const std::array<uint64_t, TABLE_LINES>& hist, uint64_t total) {
+            if (total == 0) return;
+            std::array<uint64_t, TABLE_LINES> sorted = hist;
+            std::sort(sorted.begin(), sorted.end(), std::greater<>{});
+            const int touched = static_cast<int>(std::count_if(sorted.begin(), sorted.end(), [](uint64_t n) { return n != 0; }));
+            int hot = 0;
+            for (uint64_t seen = 0; hot < TABLE_LINES && seen * 10 < total * 9; ++hot)
+                seen += sorted[hot];
+            std::println(f, "    {:<14s} {:4d} cache lines touched, {:4d} serve 90% of reads, busiest line {:5.2f}%",
+                name, touched, hot, pct(sorted[0], total));
+        };
+        std::println(f, "  Table lines (64 bytes = {} entries):", ENTRIES_PER_LINE);
+        lines("unique5", d.unique5_lines, d.unique5);
+        lines("flushes", d.flush_lines, d.flush);
+        lines("hash_values", d.hash_lines, d.hash);
+    }
+
+} // namespace poker
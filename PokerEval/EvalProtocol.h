@@ -0,0 +1,191 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+#include "Poker.h"
+#include "Showdown.h"
+
+/****************************************************************
+    Evaluation daemon wire protocol
+
+    Clients write request frames back to back on a stream socket
+    and may keep any number of them in flight; the daemon answers
+    each one with a response frame carrying the same id, not
+    necessarily in request order. All integers are little-endian
+    and cards are deck indices 0..51 (suit * 13 + rank, clubs,
+    diamonds, hearts, spades; ranks 2..A).
+
+    Request:   RequestHeader (8 bytes), then `length` payload bytes
+      EVAL5    5 cards
+      EVAL7    7 cards
+      EQUITY   players, board_count, max_boards (uint32; 0 = exact),
+               then 2 * players hole cards and board_count cards
+
+    Response:  ResponseHeader (8 bytes), then `length` payload bytes
+      EVAL5/7  `value` is the hand value (1 = royal flush), no payload
+      EQUITY   `value` is 1 if the result is exact, then one float32
+               equity per player
+****************************************************************/
+
+namespace poker::protocol {
+
+    static_assert(std::endian::native == std::endian::little, "protocol structs are little-endian");
+
+    enum class RequestType : uint8_t { Eval5 = 1, Eval7 = 2, Equity = 3 };
+
+    enum class Status : uint8_t {
+        Ok = 0,
+        BadRequest = 1,    // wrong length, invalid or repeated cards
+        UnknownType = 2
+    };
+
+    struct RequestHeader {
+        uint32_t id;
+        RequestType type;
+        uint8_t length;      // payload bytes
+        uint16_t reserved;
+    };
+    static_assert(sizeof(RequestHeader) == 8);
+
+    struct ResponseHeader {
+        uint32_t id;
+        Status status;
+        uint8_t length;      // payload bytes
+        uint16_t value;
+    };
+    static_assert(sizeof(ResponseHeader) == 8);
+
+    // Fixed part of an EQUITY payload, followed by the cards.
+    struct EquityParams {
+        uint8_t players;
+        uint8_t board_count;
+        uint8_t max_boards[4];   // uint32, unaligned
+    };
+    static_assert(sizeof(EquityParams) == 6);
+
+    inline constexpr size_t MAX_PAYLOAD = sizeof(EquityParams) + 2 * MAX_SEATS + 5;
+    inline constexpr size_t MAX_FRAME = sizeof(RequestHeader) + MAX_PAYLOAD;
+
+    // A decoded request, in Cactus Kev cards.
+    struct Request {
+        uint32_t id = 0;
+        RequestType type{};
+        Status status = Status::Ok;
+        std::array<int, 7> cards{};       // EVAL5 / EVAL7
+        Showdown equity;                  // EQUITY: holes, players, known board
+        int board_count = 0;
+        uint32_t max_boards = 0;
+    };
+
+    namespace protocol_detail {
+
+        inline void append(std::vector<uint8_t>& out, const void* p, size_t n)
+        {
+            const auto* b = static_cast<const uint8_t*>(p);
+            out.insert(out.end(), b, b + n);
+        }
+
+        // Convert deck indices to Cactus Kev cards, rejecting bad or repeated ones.
+        [[nodiscard]] inline bool load_cards(const uint8_t* in, int n, int* out, uint64_t& seen) noexcept
+        {
+            static constexpr Deck deck = init_deck();
+            for (int i = 0; i < n; ++i) {
+                if (in[i] >= 52 || (seen >> in[i] & 1)) return false;
+                seen |= uint64_t{ 1 } << in[i];
+                out[i] = deck[in[i]];
+            }
+            return true;
+        }
+
+    } // namespace protocol_detail
+
+    inline void encode_eval(std::vector<uint8_t>& out, uint32_t id, std::span<const uint8_t> cards)
+    {
+        const RequestHeader h{ id, cards.size() == 5 ? RequestType::Eval5 : RequestType::Eval7,
+            static_cast<uint8_t>(cards.size()), 0 };
+        protocol_detail::append(out, &h, sizeof(h));
+        protocol_detail::append(out, cards.data(), cards.size());
+    }
+
+    // holes holds 2 * players cards.
+    inline void encode_equity(std::vector<uint8_t>& out, uint32_t id, std::span<const uint8_t> holes,
+        std::span<const uint8_t> board, uint32_t max_boards)
+    {
+        const RequestHeader h{ id, RequestType::Equity,
+            static_cast<uint8_t>(sizeof(EquityParams) + holes.size() + board.size()), 0 };
+        EquityParams params{ static_cast<uint8_t>(holes.size() / 2), static_cast<uint8_t>(board.size()), {} };
+        std::memcpy(params.max_boards, &max_boards, sizeof(max_boards));
+        protocol_detail::append(out, &h, sizeof(h));
+        protocol_detail::append(out, &params, sizeof(params));
+        protocol_detail::append(out, holes.data(), holes.size());
+        protocol_detail::append(out, board.data(), board.size());
+    }
+
+    // Decode one request frame from [p, p + n). Returns the bytes consumed, or 0
+    // if the frame is incomplete. Malformed requests decode with a non-Ok status.
+    [[nodiscard]] inline size_t decode_request(const uint8_t* p, size_t n, Request& r) noexcept
+    {
+        RequestHeader h;
+        if (n < sizeof(h)) return 0;
+        std::memcpy(&h, p, sizeof(h));
+        if (n < sizeof(h) + h.length) return 0;
+
+        const uint8_t* payload = p + sizeof(h);
+        r.id = h.id;
+        r.type = h.type;
+        r.status = Status::Ok;
+        uint64_t seen = 0;
+
+        switch (h.type) {
+        case RequestType::Eval5:
+        case RequestType::Eval7: {
+            const int count = h.type == RequestType::Eval5 ? 5 : 7;
+            if (h.length != count || !protocol_detail::load_cards(payload, count, r.cards.data(), seen))
+                r.status = Status::BadRequest;
+            break;
+        }
+        case RequestType::Equity: {
+            EquityParams params;
+            if (h.length < sizeof(params)) {
+                r.status = Status::BadRequest;
+                break;
+            }
+            std::memcpy(&params, payload, sizeof(params));
+            std::memcpy(&r.max_boards, params.max_boards, sizeof(r.max_boards));
+            const uint8_t* cards = payload + sizeof(params);
+            if (params.players < 1 || params.players > MAX_SEATS || params.board_count > 5
+                || h.length != sizeof(params) + 2 * params.players + params.board_count) {
+                r.status = Status::BadRequest;
+                break;
+            }
+            r.equity.players = params.players;
+            r.board_count = params.board_count;
+            for (int i = 0; i < params.players && r.status == Status::Ok; ++i)
+                if (!protocol_detail::load_cards(cards + 2 * i, 2, r.equity.holes[i].data(), seen))
+                    r.status = Status::BadRequest;
+            if (r.status == Status::Ok
+                && !protocol_detail::load_cards(cards + 2 * params.players, params.board_count, r.equity.board.data(), seen))
+                r.status = Status::BadRequest;
+            break;
+        }
+        default:
+            r.status = Status::UnknownType;
+            break;
+        }
+        return sizeof(h) + h.length;
+    }
+
+    // Append a response frame; `equity` is empty except for EQUITY responses.
+    inline void encode_response(std::vector<uint8_t>& out, uint32_t id, Status status, uint16_t value,
+        std::span<const float> equity = {})
+    {
+        const ResponseHeader h{ id, status, static_cast<uint8_t>(equity.size() * sizeof(float)), value };
+        protocol_detail::append(out, &h, sizeof(h));
+        protocol_detail::append(out, equity.data(), equity.size_bytes());
+    }
+
+} // namespace poker::protocol
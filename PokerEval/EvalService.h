@@ -0,0 +1,394 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "Poker.h"
+#include "Showdown.h"
+#include "LatencyHistogram.h"
+
+/****************************************************************
+    In-process batch evaluation service
+
+    Producers on any thread submit single hands (5 or 7 cards) or
+    whole showdowns. Requests go into an intrusive lock-free MPSC
+    queue (Vyukov); one collector thread drains it into batches of
+    up to max_batch requests, waiting at most max_delay after the
+    oldest request for a batch to fill, and hands the batches to
+    the evaluation workers. Results come back through std::future
+    or by resuming a coroutine that co_awaits evaluate().
+
+        EvalService svc({ .workers = 2, .max_batch = 64 });
+        auto f = svc.submit(hand);              // std::future<unsigned short>
+        unsigned short v = co_await svc.evaluate(hand);
+****************************************************************/
+
+namespace poker {
+
+    struct ServiceOptions {
+        unsigned workers = 1;                        // evaluation threads
+        size_t max_batch = 64;                       // requests per batch
+        std::chrono::microseconds max_delay{ 50 };   // longest a partial batch waits
+    };
+
+    struct ServiceMetrics {
+        uint64_t submitted = 0;
+        uint64_t completed = 0;
+        uint64_t batches = 0;
+        uint64_t queue_depth = 0;        // submitted but not yet batched
+        uint64_t max_queue_depth = 0;
+        double mean_batch_size = 0;
+        // Submit-to-completion latency in microseconds
+        double p50_us = 0;
+        double p99_us = 0;
+        double p999_us = 0;
+        double max_us = 0;
+    };
+
+    namespace service_detail {
+
+        struct ShowdownData {
+            Showdown in;
+            ShowdownResult out;
+        };
+
+        struct Request {
+            std::atomic<Request*> next{ nullptr };
+            void (*complete)(Request*) = nullptr;   // may free or resume; last touch
+            std::chrono::steady_clock::time_point submitted{};
+            int card_count = 0;                     // 5, 7, or 0 for a showdown
+            std::array<int, 7> cards{};
+            unsigned short value = 0;
+            ShowdownData* showdown = nullptr;
+        };
+
+        // Intrusive multi-producer single-consumer queue (D. Vyukov).
+        // push() is wait-free; pop() may briefly report empty while a
+        // producer is between its exchange and its link store.
+        class MpscQueue {
+        public:
+            MpscQueue() : head_(&stub_), tail_(&stub_) {}
+
+            void push(Request* r) noexcept
+            {
+                r->next.store(nullptr, std::memory_order_relaxed);
+                Request* prev = head_.exchange(r, std::memory_order_acq_rel);
+                prev->next.store(r, std::memory_order_release);
+            }
+
+            Request* pop() noexcept
+            {
+                Request* tail = tail_;
+                Request* next = tail->next.load(std::memory_order_acquire);
+                if (tail == &stub_) {
+                    if (!next) return nullptr;
+                    tail_ = next;
+                    tail = next;
+                    next = next->next.load(std::memory_order_acquire);
+                }
+                if (next) {
+                    tail_ = next;
+                    return tail;
+                }
+                if (tail != head_.load(std::memory_order_acquire))
+                    return nullptr;
+                push(&stub_);
+                next = tail->next.load(std::memory_order_acquire);
+                if (next) {
+                    tail_ = next;
+                    return tail;
+                }
+                return nullptr;
+            }
+
+        private:
+            Request stub_;
+            alignas(64) std::atomic<Request*> head_;
+            alignas(64) Request* tail_;
+        };
+
+        template<typename T>
+        struct FutureRequest : Request {
+            std::promise<T> promise;
+        };
+
+        struct FutureShowdown : FutureRequest<ShowdownResult> {
+            ShowdownData data;
+        };
+
+        struct AwaitRequest : Request {
+            std::coroutine_handle<> handle;
+        };
+
+    } // namespace service_detail
+
+    class EvalService {
+        using Request = service_detail::Request;
+        using clock = std::chrono::steady_clock;
+
+    public:
+        explicit EvalService(ServiceOptions options = {})
+            : options_(options), workers_(std::max(1u, options.workers))
+        {
+            options_.max_batch = std::max<size_t>(1, options_.max_batch);
+            for (auto& w : workers_)
+                w.thread = std::thread([this, &w] { work(w); });
+            collector_ = std::thread([this] { collect(); });
+        }
+
+        // Outstanding requests are finished before the threads exit.
+        ~EvalService()
+        {
+            stop_.store(true, std::memory_order_release);
+            signal_.fetch_add(1, std::memory_order_release);
+            signal_.notify_one();
+            collector_.join();
+            {
+                std::lock_guard lock(batch_mutex_);
+                workers_stop_ = true;
+            }
+            batch_ready_.notify_all();
+            for (auto& w : workers_)
+                w.thread.join();
+        }
+
+        EvalService(const EvalService&) = delete;
+        EvalService& operator=(const EvalService&) = delete;
+
+        // Evaluate a 5- or 7-card hand.
+        [[nodiscard]] std::future<unsigned short> submit(std::span<const int> hand)
+        {
+            auto* r = new service_detail::FutureRequest<unsigned short>;
+            fill(*r, hand);
+            r->complete = [](Request* base) {
+                auto* f = static_cast<service_detail::FutureRequest<unsigned short>*>(base);
+                f->promise.set_value(f->value);
+                delete f;
+            };
+            auto future = r->promise.get_future();
+            enqueue(r);
+            return future;
+        }
+
+        // Evaluate every seat of a showdown and find the winners.
+        [[nodiscard]] std::future<ShowdownResult> submit(const Showdown& showdown)
+        {
+            auto* r = new service_detail::FutureShowdown;
+            r->data.in = showdown;
+            r->showdown = &r->data;
+            r->complete = [](Request* base) {
+                auto* f = static_cast<service_detail::FutureShowdown*>(base);
+                f->promise.set_value(f->data.out);
+                delete f;
+            };
+            auto future = r->promise.get_future();
+            enqueue(r);
+            return future;
+        }
+
+        // co_await service.evaluate(hand): the coroutine resumes on a worker thread.
+        class HandAwaitable {
+        public:
+            HandAwaitable(EvalService& service, std::span<const int> hand) : service_(service)
+            {
+                fill(request_, hand);
+            }
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h)
+            {
+                request_.handle = h;
+                request_.complete = [](Request* r) {
+                    static_cast<service_detail::AwaitRequest*>(r)->handle.resume();
+                };
+                service_.enqueue(&request_);
+            }
+            unsigned short await_resume() const noexcept { return request_.value; }
+
+        private:
+            EvalService& service_;
+            service_detail::AwaitRequest request_;
+        };
+
+        class ShowdownAwaitable {
+        public:
+            ShowdownAwaitable(EvalService& service, const Showdown& showdown) : service_(service)
+            {
+                data_.in = showdown;
+                request_.showdown = &data_;
+            }
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h)
+            {
+                request_.handle = h;
+                request_.complete = [](Request* r) {
+                    static_cast<service_detail::AwaitRequest*>(r)->handle.resume();
+                };
+                service_.enqueue(&request_);
+            }
+            ShowdownResult await_resume() const noexcept { return data_.out; }
+
+        private:
+            EvalService& service_;
+            service_detail::ShowdownData data_;
+            service_detail::AwaitRequest request_;
+        };
+
+        [[nodiscard]] HandAwaitable evaluate(std::span<const int> hand) { return { *this, hand }; }
+        [[nodiscard]] ShowdownAwaitable evaluate(const Showdown& showdown) { return { *this, showdown }; }
+
+        [[nodiscard]] ServiceMetrics metrics() const
+        {
+            ServiceMetrics m;
+            m.submitted = submitted_.load(std::memory_order_relaxed);
+            m.completed = completed_.load(std::memory_order_relaxed);
+            m.batches = batches_.load(std::memory_order_relaxed);
+            m.queue_depth = depth_.load(std::memory_order_relaxed);
+            m.max_queue_depth = max_depth_.load(std::memory_order_relaxed);
+            m.mean_batch_size = m.batches ? static_cast<double>(m.completed) / m.batches : 0;
+
+            LatencyHistogram latency;
+            for (const auto& w : workers_) {
+                std::lock_guard lock(w.mutex);
+                latency.merge(w.latency);
+            }
+            m.p50_us = latency.percentile(0.50) / 1e3;
+            m.p99_us = latency.percentile(0.99) / 1e3;
+            m.p999_us = latency.percentile(0.999) / 1e3;
+            m.max_us = latency.max() / 1e3;
+            return m;
+        }
+
+    private:
+        struct Worker {
+            std::thread thread;
+            mutable std::mutex mutex;
+            LatencyHistogram latency;   // nanoseconds
+        };
+
+        static void fill(Request& r, std::span<const int> hand)
+        {
+            if (hand.size() != 5 && hand.size() != 7)
+                throw std::invalid_argument("EvalService: hands must have 5 or 7 cards");
+            r.card_count = static_cast<int>(hand.size());
+            std::copy(hand.begin(), hand.end(), r.cards.begin());
+        }
+
+        void enqueue(Request* r)
+        {
+            r->submitted = clock::now();
+            submitted_.fetch_add(1, std::memory_order_relaxed);
+            const uint64_t depth = depth_.fetch_add(1, std::memory_order_relaxed) + 1;
+            for (uint64_t cur = max_depth_.load(std::memory_order_relaxed);
+                 depth > cur && !max_depth_.compare_exchange_weak(cur, depth, std::memory_order_relaxed); ) {}
+
+            queue_.push(r);
+            signal_.fetch_add(1, std::memory_order_release);
+            signal_.notify_one();
+        }
+
+        // Single consumer: drain the MPSC queue into batches.
+        void collect()
+        {
+            std::vector<Request*> batch;
+            for (;;) {
+                const uint32_t seen = signal_.load(std::memory_order_acquire);
+                Request* first = queue_.pop();
+                if (!first) {
+                    if (stop_.load(std::memory_order_acquire) && depth_.load(std::memory_order_acquire) == 0)
+                        return;
+                    if (!stop_.load(std::memory_order_acquire))
+                        signal_.wait(seen, std::memory_order_acquire);
+                    continue;
+                }
+
+                batch.push_back(first);
+                const auto deadline = first->submitted + options_.max_delay;
+                while (batch.size() < options_.max_batch) {
+                    if (Request* r = queue_.pop()) {
+                        batch.push_back(r);
+                        continue;
+                    }
+                    if (stop_.load(std::memory_order_relaxed) || clock::now() >= deadline)
+                        break;
+                    std::this_thread::yield();
+                }
+
+                depth_.fetch_sub(batch.size(), std::memory_order_relaxed);
+                {
+                    std::lock_guard lock(batch_mutex_);
+                    batches_pending_.push_back(std::move(batch));
+                }
+                batch_ready_.notify_one();
+                batch.clear();
+            }
+        }
+
+        void work(Worker& self)
+        {
+            for (;;) {
+                std::vector<Request*> batch;
+                {
+                    std::unique_lock lock(batch_mutex_);
+                    batch_ready_.wait(lock, [this] { return workers_stop_ || !batches_pending_.empty(); });
+                    if (batches_pending_.empty()) return;
+                    batch = std::move(batches_pending_.front());
+                    batches_pending_.pop_front();
+                }
+
+                for (Request* r : batch) {
+                    if (r->card_count == 5)
+                        r->value = eval_5hand(std::span<const int>{ r->cards.data(), 5 });
+                    else if (r->card_count == 7)
+                        r->value = eval_7hand(r->cards);
+                    else
+                        r->showdown->out = evaluate_showdown(r->showdown->in);
+                }
+
+                const auto now = clock::now();
+                {
+                    std::lock_guard lock(self.mutex);
+                    for (Request* r : batch)
+                        self.latency.record(static_cast<uint64_t>(
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(now - r->submitted).count()));
+                }
+                batches_.fetch_add(1, std::memory_order_relaxed);
+                completed_.fetch_add(batch.size(), std::memory_order_relaxed);
+
+                for (Request* r : batch)
+                    r->complete(r);
+            }
+        }
+
+        ServiceOptions options_;
+        service_detail::MpscQueue queue_;
+
+        alignas(64) std::atomic<uint32_t> signal_{ 0 };
+        std::atomic<bool> stop_{ false };
+
+        alignas(64) std::atomic<uint64_t> submitted_{ 0 };
+        std::atomic<uint64_t> depth_{ 0 };
+        std::atomic<uint64_t> max_depth_{ 0 };
+        alignas(64) std::atomic<uint64_t> completed_{ 0 };
+        std::atomic<uint64_t> batches_{ 0 };
+
+        std::mutex batch_mutex_;
+        std::condition_variable batch_ready_;
+        std::deque<std::vector<Request*>> batches_pending_;
+        bool workers_stop_ = false;
+
+        std::deque<Worker> workers_;
+        std::thread collector_;
+    };
+
+} // namespace poker
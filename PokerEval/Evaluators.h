@@ -0,0 +1,200 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Poker.h"
+#include "Prefetch.h"
+#include "BitSliced.h"
+#include "Compact7.h"
+
+/****************************************************************
+    Evaluator registry
+
+    Every evaluator kernel, selectable by name (Benchmark
+    --evaluator, Verify --evaluator). An entry works on whole
+    batches of hands stored back to back (`cards` ints each), so
+    a batch evaluator can reorder or prefetch as it likes and a
+    per-hand one pays no indirect call per hand:
+
+        checksum   sum of the values, the quantity timed
+        values     every value, for distributions and cross-checks
+        single     one hand per call, for latency mode (null for
+                   evaluators that only work on batches)
+        lookahead  checksum with a given prefetch distance, for
+                   pipelined evaluators (null otherwise)
+
+    Names may repeat across card counts ("kev" is both the 5-card
+    and the 7-card Cactus Kev path).
+****************************************************************/
+
+namespace poker {
+
+    using ChecksumFn = unsigned long long (*)(const int* hands, size_t count) noexcept;
+    using ValuesFn = void (*)(const int* hands, size_t count, unsigned short* out) noexcept;
+    using SingleFn = unsigned short (*)(const int* hand) noexcept;
+    using LookaheadFn = unsigned long long (*)(const int* hands, size_t count, int lookahead) noexcept;
+
+    struct Evaluator {
+        std::string_view name;
+        int cards;
+        std::string_view description;
+        ChecksumFn checksum;
+        ValuesFn values;
+        SingleFn single;
+        LookaheadFn lookahead = nullptr;
+    };
+
+    namespace evaluators_detail {
+
+        inline unsigned short kev5(const int* h) noexcept
+        {
+            return eval_5cards(h[0], h[1], h[2], h[3], h[4]);
+        }
+
+        inline unsigned short kev7(const int* h) noexcept
+        {
+            return eval_7hand(Hand{ h, 7 });
+        }
+
+        inline unsigned short compact7(const int* h) noexcept
+        {
+            return eval_7cards_compact(h);
+        }
+
+        inline unsigned short kev5_branchless(const int* h) noexcept
+        {
+            return eval_5cards_branchless(h[0], h[1], h[2], h[3], h[4]);
+        }
+
+        inline unsigned short kev7_branchless(const int* h) noexcept
+        {
+            return eval_7hand_branchless(Hand{ h, 7 });
+        }
+
+        template<int N, unsigned short (*Eval)(const int*) noexcept>
+        unsigned long long checksum_of(const int* hands, size_t count) noexcept
+        {
+            unsigned long long sum = 0;
+            for (size_t i = 0; i < count; ++i)
+                sum += Eval(hands + i * N);
+            return sum;
+        }
+
+        template<int N, unsigned short (*Eval)(const int*) noexcept>
+        void values_of(const int* hands, size_t count, unsigned short* out) noexcept
+        {
+            for (size_t i = 0; i < count; ++i)
+                out[i] = Eval(hands + i * N);
+        }
+
+        // Registry entry for an evaluator that scores one hand per call.
+        template<int N, unsigned short (*Eval)(const int*) noexcept>
+        constexpr Evaluator per_hand(std::string_view name, std::string_view description)
+        {
+            return { name, N, description, &checksum_of<N, Eval>, &values_of<N, Eval>, Eval };
+        }
+
+        // Pipelined batch kernels (Prefetch.h) at a given lookahead
+        template<int N>
+        unsigned long long checksum_at(const int* hands, size_t count, int lookahead) noexcept
+        {
+            unsigned long long sum = 0;
+            auto add = [&](size_t, unsigned short v) { sum += v; };
+            if constexpr (N == 5)
+                eval_5cards_pipelined(hands, count, lookahead, add);
+            else
+                eval_7hand_pipelined(hands, count, lookahead, add);
+            return sum;
+        }
+
+        template<int N>
+        unsigned long long checksum_pipelined(const int* hands, size_t count) noexcept
+        {
+            return checksum_at<N>(hands, count, DEFAULT_LOOKAHEAD);
+        }
+
+        template<int N>
+        void values_pipelined(const int* hands, size_t count, unsigned short* out) noexcept
+        {
+            auto store = [out](size_t i, unsigned short v) { out[i] = v; };
+            if constexpr (N == 5)
+                eval_5cards_pipelined(hands, count, DEFAULT_LOOKAHEAD, store);
+            else
+                eval_7hand_pipelined(hands, count, DEFAULT_LOOKAHEAD, store);
+        }
+
+        // Registry entry for a software-prefetching pipeline; batch only.
+        template<int N>
+        constexpr Evaluator pipelined(std::string_view name, std::string_view description)
+        {
+            return { name, N, description, &checksum_pipelined<N>, &values_pipelined<N>, nullptr, &checksum_at<N> };
+        }
+
+        // Bit-sliced kernels (BitSliced.h), one block of 64 * Words hands at a time
+        template<int N, int Words>
+        void values_bitsliced(const int* hands, size_t count, unsigned short* out) noexcept
+        {
+            eval_bitsliced<Words>(hands, count, N, out);
+        }
+
+        template<int N, int Words>
+        unsigned long long checksum_bitsliced(const int* hands, size_t count) noexcept
+        {
+            BitSlicedBlock<Words> block;
+            constexpr size_t LANES = BitSlicedBlock<Words>::LANES;
+            std::array<unsigned short, LANES> values;
+            unsigned long long sum = 0;
+            for (size_t b = 0; b < count; b += LANES) {
+                const size_t n = std::min(count - b, LANES);
+                block.load(hands + b * N, n, N);
+                block.evaluate();
+                block.store(values.data(), n);
+                for (size_t i = 0; i < n; ++i)
+                    sum += values[i];
+            }
+            return sum;
+        }
+
+        template<int N, int Words>
+        constexpr Evaluator bitsliced(std::string_view name, std::string_view description)
+        {
+            return { name, N, description, &checksum_bitsliced<N, Words>, &values_bitsliced<N, Words>, nullptr };
+        }
+
+    } // namespace evaluators_detail
+
+    [[nodiscard]] inline const std::vector<Evaluator>& evaluators()
+    {
+        using namespace evaluators_detail;
+        static const std::vector<Evaluator> list = {
+            per_hand<5, kev5>("kev", "Cactus Kev: flush and unique5 tables, then perfect-hash lookup"),
+            per_hand<7, kev7>("kev", "Cactus Kev: best of the 21 five-card subsets (perm7)"),
+            per_hand<5, kev5_branchless>("kev-branchless", "Cactus Kev, all three lookups made and selected with masks"),
+            per_hand<7, kev7_branchless>("kev-branchless", "Cactus Kev subsets, branch-free, no early exit"),
+            pipelined<5>("kev-prefetch", "Cactus Kev, batch pipeline prefetching table lines ahead"),
+            pipelined<7>("kev-prefetch", "Cactus Kev subsets, batch pipeline prefetching table lines ahead"),
+            bitsliced<5, 1>("bitslice", "bit-sliced boolean logic, 64 hands per uint64_t, no tables"),
+            bitsliced<7, 1>("bitslice", "bit-sliced boolean logic, 64 hands per uint64_t, no tables"),
+            bitsliced<5, 4>("bitslice256", "bit-sliced boolean logic, 256 hands per block (AVX2 width)"),
+            bitsliced<7, 4>("bitslice256", "bit-sliced boolean logic, 256 hands per block (AVX2 width)"),
+            per_hand<7, compact7>("compact", "rank-pattern perfect hash and 7-card flush table, 113 KB, fits in L2"),
+        };
+        return list;
+    }
+
+    // Evaluators for a card count, filtered by name (all when names is empty).
+    [[nodiscard]] inline std::vector<const Evaluator*> select_evaluators(int cards, const std::vector<std::string>& names)
+    {
+        std::vector<const Evaluator*> out;
+        for (const Evaluator& e : evaluators()) {
+            if (e.cards != cards) continue;
+            if (names.empty() || std::find(names.begin(), names.end(), e.name) != names.end())
+                out.push_back(&e);
+        }
+        return out;
+    }
+
+} // namespace poker
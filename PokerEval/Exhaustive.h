@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <thread>
+#include <vector>
+#include "Poker.h"
+
+/****************************************************************
+    Exhaustive 7-card sweep
+
+    Evaluates every one of the C(52,7) = 133,784,560 seven-card
+    hands with a caller-supplied evaluator and builds the full
+    7462-class histogram. Work is handed out one (first, second)
+    card pair at a time; each thread fills its own histogram and
+    the histograms are only merged once all threads have joined,
+    so the hot loop touches no shared state.
+****************************************************************/
+
+namespace poker {
+
+    inline constexpr int NUM_HAND_VALUES = 7462;
+    inline constexpr uint64_t TOTAL_7CARD_HANDS = 133'784'560;
+
+    // Expected category counts over all 133,784,560 seven-card hands.
+    inline constexpr std::array<uint64_t, 10> expected_freq7 = {
+        0, 41584, 224848, 3473184, 4047644, 6180020,
+        6461620, 31433400, 58627800, 23294460
+    };
+
+    // Only 4824 of the 7462 classes can be the best hand of seven cards.
+    inline constexpr int EXPECTED_DISTINCT_7CARD_VALUES = 4824;
+
+    // FNV-1a fingerprint of the reference 7-card histogram (counts for
+    // values 1..7462, produced by eval_7hand).
+    inline constexpr uint64_t EXPECTED_7CARD_FINGERPRINT = 0xd2dfd86bfcc1b3b3ULL;
+
+    // Histogram indexed by hand value; slot 0 collects out-of-range values.
+    using ValueHistogram = std::array<uint64_t, NUM_HAND_VALUES + 1>;
+
+    struct SweepResult {
+        ValueHistogram values{};
+        std::array<uint64_t, 10> categories{};
+        uint64_t total = 0;
+        int distinct = 0;
+        uint64_t fingerprint = 0;
+    };
+
+    [[nodiscard]] inline uint64_t histogram_fingerprint(const ValueHistogram& values) noexcept
+    {
+        uint64_t h = 0xcbf29ce484222325ULL;
+        for (int v = 1; v <= NUM_HAND_VALUES; ++v) {
+            uint64_t n = values[v];
+            for (int i = 0; i < 8; ++i, n >>= 8) {
+                h ^= n & 0xFF;
+                h *= 0x100000001b3ULL;
+            }
+        }
+        return h;
+    }
+
+    // Sweep all seven-card hands. `eval` is called as eval(std::span<const int, 7>)
+    // or anything convertible from it, e.g. eval_7hand.
+    template<typename Eval>
+    [[nodiscard]] SweepResult sweep_7cards(Eval eval, unsigned num_threads = 0)
+    {
+        if (num_threads == 0)
+            num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+        const Deck deck = init_deck();
+
+        // Work items are the 1,081 (a, b) prefixes with a < b <= 46.
+        std::vector<std::array<int, 2>> prefixes;
+        for (int a = 0; a < 46; ++a)
+            for (int b = a + 1; b < 47; ++b)
+                prefixes.push_back({ a, b });
+
+        std::atomic<size_t> next{ 0 };
+        std::vector<ValueHistogram> local(num_threads);
+
+        auto worker = [&](unsigned t) {
+            ValueHistogram& hist = local[t];
+            std::array<int, 7> hand;
+
+            for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < prefixes.size(); ) {
+                const auto [a, b] = prefixes[i];
+                hand[0] = deck[a];
+                hand[1] = deck[b];
+                for (int c = b + 1; c < 48; ++c) {
+                    hand[2] = deck[c];
+                    for (int d = c + 1; d < 49; ++d) {
+                        hand[3] = deck[d];
+                        for (int e = d + 1; e < 50; ++e) {
+                            hand[4] = deck[e];
+                            for (int f = e + 1; f < 51; ++f) {
+                                hand[5] = deck[f];
+                                for (int g = f + 1; g < 52; ++g) {
+                                    hand[6] = deck[g];
+                                    const unsigned v = eval(std::span<const int, 7>{ hand });
+                                    ++hist[v <= NUM_HAND_VALUES ? v : 0];
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        };
+
+        {
+            std::vector<std::jthread> threads;
+            threads.reserve(num_threads);
+            for (unsigned t = 0; t < num_threads; ++t)
+                threads.emplace_back(worker, t);
+        }
+
+        SweepResult result;
+        for (const auto& hist : local)
+            for (int v = 0; v <= NUM_HAND_VALUES; ++v)
+                result.values[v] += hist[v];
+
+        result.total = result.values[0];  // out-of-range values land in slot 0
+        for (int v = 1; v <= NUM_HAND_VALUES; ++v) {
+            const uint64_t n = result.values[v];
+            result.total += n;
+            result.categories[hand_rank(static_cast<unsigned short>(v))] += n;
+            result.distinct += (n != 0);
+        }
+        result.fingerprint = histogram_fingerprint(result.values);
+        return result;
+    }
+
+    // True if the sweep matches the known category totals and the reference histogram.
+    [[nodiscard]] inline bool sweep_matches_reference(const SweepResult& r) noexcept
+    {
+        return r.values[0] == 0
+            && r.total == TOTAL_7CARD_HANDS
+            && r.categories == expected_freq7
+            && r.distinct == EXPECTED_DISTINCT_7CARD_VALUES
+            && r.fingerprint == EXPECTED_7CARD_FINGERPRINT;
+    }
+
+} // namespace poker
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include "Poker.h"
+#include "CardParser.h"
+#include "MappedFile.h"
+
+/****************************************************************
+    Binary hand file (.phb)
+
+    Layout, all integers little-endian:
+
+        [0, 64)          HandFileHeader
+        [64, ...)        record_count hands, each card_count 6-bit
+                         deck indices (suit * 13 + rank) packed LSB
+                         first into ceil(6 * card_count / 8) bytes,
+                         followed by 8 bytes of zero padding
+        [results_offset] optional uint16_t result per hand, 64-byte
+                         aligned, present when FLAG_RESULTS is set
+
+    Readers and writers work directly on a MappedFile. Appending
+    results grows the file in place; the hand records are never
+    copied. Files come from outside, so open() checks the header's
+    offsets against the file size, and get_hand / get_indices
+    return false for a 6-bit field of 52..63.
+****************************************************************/
+
+namespace poker {
+
+    inline constexpr char HAND_FILE_MAGIC[8] = { 'P', 'K', 'H', 'A', 'N', 'D', 'S', '\0' };
+    inline constexpr uint16_t HAND_FILE_VERSION = 1;
+    inline constexpr uint8_t ENCODING_PACKED6 = 0;
+    inline constexpr uint32_t FLAG_RESULTS = 1;
+
+    struct HandFileHeader {
+        char magic[8];
+        uint16_t version;
+        uint8_t card_count;      // 5..8
+        uint8_t encoding;        // ENCODING_PACKED6
+        uint32_t flags;          // FLAG_RESULTS
+        uint64_t record_count;
+        uint64_t hands_offset;
+        uint64_t results_offset; // 0 when there is no result column
+        uint8_t reserved[24];
+    };
+    static_assert(sizeof(HandFileHeader) == 64);
+
+    // card_table extended to every 6-bit field: 52..63 map to 0
+    inline constexpr auto file_card_table = [] {
+        std::array<int, 64> t{};
+        for (int i = 0; i < 52; ++i) t[i] = card_table[i];
+        return t;
+    }();
+
+    [[nodiscard]] constexpr size_t packed_record_bytes(int card_count) noexcept
+    {
+        return static_cast<size_t>(6 * card_count + 7) / 8;
+    }
+
+    class HandFile {
+    public:
+        // Create a file for record_count hands of card_count cards; fill it with set_indices().
+        static HandFile create(const std::string& path, int card_count, uint64_t record_count)
+        {
+            if (card_count < 5 || card_count > 8)
+                throw std::invalid_argument("HandFile: card count must be 5..8");
+
+            const size_t stride = packed_record_bytes(card_count);
+            HandFile f;
+            f.file_ = MappedFile::create(path, sizeof(HandFileHeader) + stride * record_count + 8);
+
+            HandFileHeader h{};
+            std::memcpy(h.magic, HAND_FILE_MAGIC, sizeof(h.magic));
+            h.version = HAND_FILE_VERSION;
+            h.card_count = static_cast<uint8_t>(card_count);
+            h.encoding = ENCODING_PACKED6;
+            h.record_count = record_count;
+            h.hands_offset = sizeof(HandFileHeader);
+            std::memcpy(f.file_.data(), &h, sizeof(h));
+            f.load_header();
+            return f;
+        }
+
+        static HandFile open(const std::string& path, MappedFile::Mode mode = MappedFile::Mode::Read)
+        {
+            HandFile f;
+            f.file_ = MappedFile::open(path, mode);
+            f.load_header();
+            return f;
+        }
+
+        [[nodiscard]] int card_count() const noexcept { return header_.card_count; }
+        [[nodiscard]] uint64_t size() const noexcept { return header_.record_count; }
+        [[nodiscard]] bool has_results() const noexcept { return header_.flags & FLAG_RESULTS; }
+        [[nodiscard]] const HandFileHeader& header() const noexcept { return header_; }
+
+        // Deck indices of hand i. Returns false if a field holds 52..63, which
+        // only a corrupt file can; the caller must not use such an index.
+        [[nodiscard]] bool get_indices(uint64_t i, uint8_t* out) const noexcept
+        {
+            uint64_t bits;
+            std::memcpy(&bits, hands_ + i * stride_, sizeof(bits));
+            bool valid = true;
+            for (int c = 0; c < header_.card_count; ++c, bits >>= 6) {
+                out[c] = static_cast<uint8_t>(bits & 0x3F);
+                valid &= out[c] < 52;
+            }
+            return valid;
+        }
+
+        // Cactus Kev cards of hand i. Returns false if a field is not a deck
+        // index (52..63); that card is then 0, which is no card.
+        [[nodiscard]] bool get_hand(uint64_t i, int* out) const noexcept
+        {
+            uint64_t bits;
+            std::memcpy(&bits, hands_ + i * stride_, sizeof(bits));
+            bool valid = true;
+            for (int c = 0; c < header_.card_count; ++c, bits >>= 6) {
+                out[c] = file_card_table[bits & 0x3F];
+                valid &= out[c] != 0;
+            }
+            return valid;
+        }
+
+        // Store hand i from deck indices. Distinct records may be written concurrently.
+        void set_indices(uint64_t i, const uint8_t* indices) noexcept
+        {
+            uint64_t bits = 0;
+            for (int c = header_.card_count - 1; c >= 0; --c)
+                bits = (bits << 6) | indices[c];
+            std::memcpy(hands_ + i * stride_, &bits, stride_);
+        }
+
+        // Add (or replace) the uint16_t result column. Remaps the file, so
+        // previously returned pointers are invalidated.
+        std::span<uint16_t> create_results()
+        {
+            const uint64_t hands_end = header_.hands_offset + stride_ * header_.record_count + 8;
+            const uint64_t offset = (hands_end + 63) & ~uint64_t{ 63 };
+            file_.resize(offset + header_.record_count * sizeof(uint16_t));
+            header_.results_offset = offset;
+            header_.flags |= FLAG_RESULTS;
+            std::memcpy(file_.data(), &header_, sizeof(header_));
+            load_header();
+            return results();
+        }
+
+        [[nodiscard]] std::span<uint16_t> results() noexcept
+        {
+            if (!has_results()) return {};
+            return { reinterpret_cast<uint16_t*>(file_.data() + header_.results_offset), header_.record_count };
+        }
+
+        [[nodiscard]] std::span<const uint16_t> results() const noexcept
+        {
+            if (!has_results()) return {};
+            return { reinterpret_cast<const uint16_t*>(file_.data() + header_.results_offset), header_.record_count };
+        }
+
+        void flush() { file_.flush(); }
+        [[nodiscard]] MappedFile& mapped() noexcept { return file_; }
+
+    private:
+        void load_header()
+        {
+            if (file_.size() < sizeof(HandFileHeader))
+                throw std::runtime_error("HandFile: '" + file_.path() + "' is too small");
+            std::memcpy(&header_, file_.data(), sizeof(header_));
+            if (std::memcmp(header_.magic, HAND_FILE_MAGIC, sizeof(header_.magic)) != 0)
+                throw std::runtime_error("HandFile: '" + file_.path() + "' is not a hand file");
+            if (header_.version != HAND_FILE_VERSION || header_.encoding != ENCODING_PACKED6)
+                throw std::runtime_error("HandFile: '" + file_.path() + "' has an unsupported version or encoding");
+            if (header_.card_count < 5 || header_.card_count > 8)
+                throw std::runtime_error("HandFile: '" + file_.path() + "' has an invalid card count");
+
+            // Compare by division, so a hostile header cannot wrap the sums
+            stride_ = packed_record_bytes(header_.card_count);
+            const uint64_t size = file_.size();
+            const bool hands_fit = header_.hands_offset <= size && size - header_.hands_offset >= 8
+                && header_.record_count <= (size - header_.hands_offset - 8) / stride_;
+            const bool results_fit = !(header_.flags & FLAG_RESULTS) || (header_.results_offset <= size
+                && header_.record_count <= (size - header_.results_offset) / sizeof(uint16_t));
+            if (!hands_fit || !results_fit)
+                throw std::runtime_error("HandFile: '" + file_.path() + "' is truncated");
+
+            hands_ = reinterpret_cast<uint8_t*>(file_.data()) + header_.hands_offset;
+        }
+
+        MappedFile file_;
+        HandFileHeader header_{};
+        size_t stride_ = 0;
+        uint8_t* hands_ = nullptr;
+    };
+
+} // namespace poker
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include "Poker.h"
+#include "CardParser.h"
+#include "Showdown.h"
+
+/****************************************************************
+    Hand history record parser
+
+    Reads Hold'em hand histories in the common online-room text
+    format, where every record starts with a "PokerStars " line and
+    ends with a summary section:
+
+        *** SUMMARY ***
+        Total pot $20.50 | Rake $0.50
+        Board [2c 3d 4h 5s 6c]
+        Seat 1: Alice (button) showed [Ah Kd] and won ($20) with ...
+        Seat 3: Bob showed [7c 7d] and lost with a pair of Sevens
+        Seat 4: Carol mucked [Qs Jc]
+
+    Only the first line and the summary are looked at: the board,
+    the cards of every player who showed or mucked at showdown, and
+    whether each of them claims to have won. Lines are scanned in
+    place with memchr, and names and hand ids are views into the
+    buffer, so records must not outlive it.
+
+    Records with fewer than two shown hands or an incomplete board
+    have no showdown to check. Other games (Omaha, stud) and boards
+    that were run more than once are reported as unsupported.
+****************************************************************/
+
+namespace poker {
+
+    inline constexpr std::string_view HAND_RECORD_MARKER = "PokerStars ";
+
+    enum class RecordStatus : uint8_t {
+        Showdown,      // parsed, with a showdown to check
+        NoShowdown,    // parsed, nothing to check
+        Unsupported,   // a game or format the evaluator does not cover
+        Malformed      // bad or duplicate cards, too many players
+    };
+
+    struct HandRecord {
+        std::string_view id;
+        Showdown showdown;
+        std::array<std::string_view, MAX_SEATS> names{};
+        uint16_t claimed = 0;    // bit i set if player i claims a share of some pot
+        bool side_pot = false;
+    };
+
+    namespace history_detail {
+
+        [[nodiscard]] inline bool starts_with(const char* p, const char* end, std::string_view s) noexcept
+        {
+            return static_cast<size_t>(end - p) >= s.size() && std::memcmp(p, s.data(), s.size()) == 0;
+        }
+
+        [[nodiscard]] inline const char* find(const char* p, const char* end, std::string_view s) noexcept
+        {
+            const std::string_view hay(p, static_cast<size_t>(end - p));
+            const size_t at = hay.find(s);
+            return at == std::string_view::npos ? nullptr : p + at;
+        }
+
+        [[nodiscard]] inline const char* line_end(const char* p, const char* end) noexcept
+        {
+            const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+            return nl ? nl : end;
+        }
+
+        // Parse "[c1 c2 ...]" at p into Cactus Kev cards, also adding their deck
+        // bits to seen. Returns the card count, or -1 on a bad or repeated card.
+        inline int parse_bracket(const char* p, const char* end, int* out, int max_cards, uint64_t& seen) noexcept
+        {
+            if (p == end || *p != '[') return -1;
+            const char* close = static_cast<const char*>(std::memchr(p, ']', static_cast<size_t>(end - p)));
+            if (!close) return -1;
+
+            int n = 0;
+            for (const char* c = p + 1; c < close; ) {
+                while (c < close && is_blank(*c)) ++c;
+                if (c == close) break;
+                if (close - c < 2 || n == max_cards) return -1;
+                const uint8_t index = parse_card_index(c);
+                if (index == NOT_A_CARD || (seen >> index & 1)) return -1;
+                seen |= uint64_t{ 1 } << index;
+                out[n++] = card_table[index];
+                c += 2;
+            }
+            return n;
+        }
+
+    } // namespace history_detail
+
+    // Start of the first record beginning at or after p, or end.
+    [[nodiscard]] inline const char* find_record_start(const char* p, const char* begin, const char* end) noexcept
+    {
+        using namespace history_detail;
+        // Skip the rest of a line that p is in the middle of
+        if (p > begin && p < end && p[-1] != '\n') {
+            const char* eol = line_end(p, end);
+            p = (eol == end) ? end : eol + 1;
+        }
+        while (p < end) {
+            if (starts_with(p, end, HAND_RECORD_MARKER)) return p;
+            const char* eol = line_end(p, end);
+            p = (eol == end) ? end : eol + 1;
+        }
+        return end;
+    }
+
+    // Parse the record in [begin, end), which starts with HAND_RECORD_MARKER.
+    [[nodiscard]] inline RecordStatus parse_hand_record(const char* begin, const char* end, HandRecord& out) noexcept
+    {
+        using namespace history_detail;
+
+        out.showdown.players = 0;
+        out.claimed = 0;
+        out.side_pot = false;
+
+        // "PokerStars Hand #123456789: Hold'em No Limit ($0.05/$0.10) - ..."
+        const char* eol = line_end(begin, end);
+        const char* hash = find(begin, eol, "#");
+        const char* colon = hash ? static_cast<const char*>(std::memchr(hash, ':', static_cast<size_t>(eol - hash))) : nullptr;
+        if (!colon) return RecordStatus::Malformed;
+        out.id = std::string_view(hash + 1, static_cast<size_t>(colon - hash - 1));
+        if (!find(colon, eol, "Hold'em")) return RecordStatus::Unsupported;
+
+        const char* summary = find(eol, end, "*** SUMMARY ***");
+        if (!summary) return RecordStatus::Malformed;
+
+        uint64_t seen = 0;
+        int board_cards = 0;
+        bool multiple_boards = false;
+
+        for (const char* line = line_end(summary, end); line < end; ) {
+            if (*line == '\n') ++line;
+            eol = line_end(line, end);
+
+            if (starts_with(line, eol, "Board [")) {
+                board_cards = parse_bracket(line + 6, eol, out.showdown.board.data(), 5, seen);
+                if (board_cards < 0) return RecordStatus::Malformed;
+            } else if (starts_with(line, eol, "FIRST Board") || starts_with(line, eol, "SECOND Board")) {
+                multiple_boards = true;
+            } else if (starts_with(line, eol, "Total pot")) {
+                out.side_pot = find(line, eol, "Side pot") != nullptr;
+            } else if (starts_with(line, eol, "Seat ")) {
+                // "Seat 3: <name> [(position)] showed [Ah Kd] and won ..." or "... mucked [Ah Kd]"
+                const char* name = find(line, eol, ": ");
+                const char* shown = find(line, eol, " showed [");
+                const char* mucked = shown ? nullptr : find(line, eol, " mucked [");
+                const char* cards = shown ? shown + 8 : mucked ? mucked + 8 : nullptr;
+                if (name && cards) {
+                    const int p = out.showdown.players;
+                    if (p == MAX_SEATS) return RecordStatus::Malformed;
+
+                    std::array<int, 4> hole;
+                    const int n = parse_bracket(cards, eol, hole.data(), 4, seen);
+                    if (n < 0) return RecordStatus::Malformed;
+                    if (n != 2) return RecordStatus::Unsupported;
+                    out.showdown.holes[p] = { hole[0], hole[1] };
+
+                    std::string_view who(name + 2, static_cast<size_t>(cards - 8 - name - 2));
+                    if (who.ends_with(')'))
+                        if (const size_t open = who.rfind(" ("); open != std::string_view::npos)
+                            who = who.substr(0, open);
+                    out.names[p] = who;
+
+                    if (shown && find(cards, eol, "] and won"))
+                        out.claimed |= static_cast<uint16_t>(1u << p);
+                    ++out.showdown.players;
+                }
+            }
+            line = eol;
+        }
+
+        if (multiple_boards) return RecordStatus::Unsupported;
+        if (out.showdown.players < 2 || board_cards != 5) return RecordStatus::NoShowdown;
+        return RecordStatus::Showdown;
+    }
+
+    // Whether the claimed winners agree with the evaluated ones. Without side
+    // pots they must be identical; with side pots, players can also win a
+    // side pot with a worse hand, so only the best hands must be among them.
+    [[nodiscard]] inline bool showdown_matches(const HandRecord& record, const ShowdownResult& result) noexcept
+    {
+        if (record.side_pot)
+            return (result.winners & ~record.claimed) == 0;
+        return result.winners == record.claimed;
+    }
+
+} // namespace poker
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <new>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+/****************************************************************
+    Huge-page memory for large tables and batch buffers
+
+    A 4 KB page covers little, so a buffer in the gigabytes, or a
+    267 MB table read at random (Table7), misses the dTLB on
+    nearly every access and pays for a page walk. PageBuffer
+    with HugePages::On tries, in order:
+
+        1 GB pages     MAP_HUGETLB | MAP_HUGE_1GB, for 1 GB or more
+        2 MB pages     MAP_HUGETLB | MAP_HUGE_2MB
+        transparent    plain mapping + madvise(MADV_HUGEPAGE)
+        4 KB pages     plain mapping
+
+    Explicit pages come from a pool the administrator reserves
+    (vm.nr_hugepages, hugepages= at boot). Transparent ones need
+    /sys/kernel/mm/transparent_hugepage/enabled set to "madvise"
+    or "always", and the kernel falls back to 4 KB pages when it
+    has no free 2 MB blocks. backing() names the path taken, and
+    huge_bytes() checks how much of a transparent mapping is
+    actually huge. On Windows, On asks for large pages, which need
+    the "Lock pages in memory" privilege.
+
+    HugePages::Off maps 4 KB pages and opts out of transparent
+    huge pages, so a benchmark can compare the two even when THP
+    is "always". The memory is zero-filled, lazily, by the OS.
+****************************************************************/
+
+namespace poker {
+
+    enum class HugePages { Off, On };
+
+    enum class PageBacking { Small, Transparent, Huge2M, Huge1G };
+
+    [[nodiscard]] constexpr std::string_view to_string(PageBacking b) noexcept
+    {
+        switch (b) {
+        case PageBacking::Transparent: return "transparent huge pages";
+        case PageBacking::Huge2M: return "2 MB pages";
+        case PageBacking::Huge1G: return "1 GB pages";
+        default: return "4 KB pages";
+        }
+    }
+
+    class PageBuffer {
+    public:
+        PageBuffer() = default;
+
+        PageBuffer(size_t bytes, HugePages pages)
+        {
+            if (bytes == 0) return;
+#ifdef _WIN32
+            if (pages == HugePages::On) {
+                if (const size_t large = GetLargePageMinimum()) {
+                    const size_t rounded = (bytes + large - 1) / large * large;
+                    if (void* p = VirtualAlloc(nullptr, rounded, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE)) {
+                        data_ = p;
+                        mapped_ = rounded;
+                        backing_ = PageBacking::Huge2M;
+                        return;
+                    }
+                }
+            }
+            data_ = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+            if (!data_) throw std::bad_alloc();
+            mapped_ = bytes;
+#else
+            if (pages == HugePages::On) {
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+                if (bytes >= GIB && map_explicit(bytes, GIB, 30)) {
+                    backing_ = PageBacking::Huge1G;
+                    return;
+                }
+                if (map_explicit(bytes, 2 * MIB, 21)) {
+                    backing_ = PageBacking::Huge2M;
+                    return;
+                }
+#endif
+            }
+            void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED) throw std::bad_alloc();
+            data_ = p;
+            mapped_ = bytes;
+#if defined(MADV_HUGEPAGE) && defined(MADV_NOHUGEPAGE)
+            if (pages == HugePages::On) {
+                if (madvise(p, bytes, MADV_HUGEPAGE) == 0) backing_ = PageBacking::Transparent;
+            } else {
+                (void)madvise(p, bytes, MADV_NOHUGEPAGE);
+            }
+#endif
+#endif
+        }
+
+        PageBuffer(PageBuffer&& o) noexcept { swap(o); }
+        PageBuffer& operator=(PageBuffer&& o) noexcept
+        {
+            if (this != &o) {
+                release();
+                swap(o);
+            }
+            return *this;
+        }
+        PageBuffer(const PageBuffer&) = delete;
+        PageBuffer& operator=(const PageBuffer&) = delete;
+        ~PageBuffer() { release(); }
+
+        [[nodiscard]] void* data() const noexcept { return data_; }
+        // Bytes mapped, rounded up to the page size for explicit huge pages
+        [[nodiscard]] size_t size() const noexcept { return mapped_; }
+        [[nodiscard]] PageBacking backing() const noexcept { return backing_; }
+
+        // Bytes of the buffer on huge pages: all of it for explicit pages,
+        // what the kernel granted so far (AnonHugePages in /proc/self/smaps)
+        // for transparent ones, 0 when unknown or none.
+        [[nodiscard]] size_t huge_bytes() const
+        {
+            switch (backing_) {
+            case PageBacking::Huge1G:
+            case PageBacking::Huge2M: return mapped_;
+            case PageBacking::Transparent: return transparent_bytes();
+            default: return 0;
+            }
+        }
+
+    private:
+        static constexpr size_t MIB = size_t{ 1 } << 20;
+        static constexpr size_t GIB = size_t{ 1 } << 30;
+
+#if !defined(_WIN32) && defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+        bool map_explicit(size_t bytes, size_t page, int log2_page) noexcept
+        {
+            const size_t rounded = (bytes + page - 1) & ~(page - 1);
+            void* p = mmap(nullptr, rounded, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (log2_page << MAP_HUGE_SHIFT), -1, 0);
+            if (p == MAP_FAILED) return false;
+            data_ = p;
+            mapped_ = rounded;
+            return true;
+        }
+#endif
+
+        // Sum AnonHugePages over the smaps entries inside this buffer
+        [[nodiscard]] size_t transparent_bytes() const
+        {
+#ifdef _WIN32
+            return 0;
+#else
+            std::ifstream smaps("/proc/self/smaps");
+            const auto begin = reinterpret_cast<uintptr_t>(data_);
+            const uintptr_t end = begin + mapped_;
+            size_t total = 0;
+            bool inside = false;
+            for (std::string line; std::getline(smaps, line); ) {
+                uintptr_t lo = 0, hi = 0;
+                if (const size_t dash = line.find('-'); dash != std::string::npos && dash < 17 && line.find(' ') > dash) {
+                    lo = std::stoull(line.substr(0, dash), nullptr, 16);
+                    hi = std::stoull(line.substr(dash + 1, line.find(' ') - dash - 1), nullptr, 16);
+                    inside = lo < end && hi > begin;
+                } else if (inside && line.starts_with("AnonHugePages:")) {
+                    total += std::stoull(line.substr(14)) * 1024;
+                }
+            }
+            return total;
+#endif
+        }
+
+        void swap(PageBuffer& o) noexcept
+        {
+            std::swap(data_, o.data_);
+            std::swap(mapped_, o.mapped_);
+            std::swap(backing_, o.backing_);
+        }
+
+        void release() noexcept
+        {
+            if (!data_) return;
+#ifdef _WIN32
+            VirtualFree(data_, 0, MEM_RELEASE);
+#else
+            munmap(data_, mapped_);
+#endif
+            data_ = nullptr;
+            mapped_ = 0;
+        }
+
+        void* data_ = nullptr;
+        size_t mapped_ = 0;
+        PageBacking backing_ = PageBacking::Small;
+    };
+
+} // namespace poker
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <print>
+
+/****************************************************************
+    Log-linear latency histogram
+
+    HDR-style bucketing: values are grouped by their highest set
+    bit, and each power-of-two range is split into 32 linear
+    slots, giving about 3% relative precision from 1 unit up to
+    2^64 in a fixed 15 KB of counters. Units are whatever the
+    caller records (nanoseconds, TSC ticks, ...).
+****************************************************************/
+
+namespace poker {
+
+    class LatencyHistogram {
+    public:
+        static constexpr int SUB_BITS = 6;
+        static constexpr int SUB_BUCKETS = 1 << SUB_BITS;
+        static constexpr int HALF = SUB_BUCKETS / 2;
+        static constexpr int NUM_BUCKETS = (64 - SUB_BITS + 1) * HALF + HALF;
+
+        void record(uint64_t value, uint64_t count = 1) noexcept
+        {
+            counts_[index_of(value)] += count;
+            total_ += count;
+            max_ = std::max(max_, value);
+            min_ = std::min(min_, value);
+        }
+
+        void merge(const LatencyHistogram& other) noexcept
+        {
+            for (int i = 0; i < NUM_BUCKETS; ++i)
+                counts_[i] += other.counts_[i];
+            total_ += other.total_;
+            max_ = std::max(max_, other.max_);
+            min_ = std::min(min_, other.min_);
+        }
+
+        void reset() noexcept { *this = LatencyHistogram{}; }
+
+        [[nodiscard]] uint64_t count() const noexcept { return total_; }
+        [[nodiscard]] uint64_t max() const noexcept { return total_ ? max_ : 0; }
+        [[nodiscard]] uint64_t min() const noexcept { return total_ ? min_ : 0; }
+
+        // Upper edge of the bucket holding the q-quantile sample, clamped to the maximum.
+        [[nodiscard]] uint64_t percentile(double q) const noexcept
+        {
+            if (total_ == 0) return 0;
+            const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(q * total_ + 0.5));
+            uint64_t seen = 0;
+            for (int i = 0; i < NUM_BUCKETS; ++i) {
+                seen += counts_[i];
+                if (seen >= rank)
+                    return std::min(upper_bound_of(i), max_);
+            }
+            return max_;
+        }
+
+        [[nodiscard]] double mean() const noexcept
+        {
+            if (total_ == 0) return 0;
+            double sum = 0;
+            for (int i = 0; i < NUM_BUCKETS; ++i)
+                if (counts_[i]) sum += static_cast<double>(counts_[i]) * midpoint_of(i);
+            return sum / total_;
+        }
+
+        // Visit every non-empty bucket as (lowest value, highest value, count).
+        template<typename Fn>
+        void for_each_bucket(Fn&& fn) const
+        {
+            for (int i = 0; i < NUM_BUCKETS; ++i)
+                if (counts_[i]) fn(lower_bound_of(i), upper_bound_of(i), counts_[i]);
+        }
+
+    private:
+        // Values below SUB_BUCKETS map one-to-one; above that, each power of
+        // two gets HALF slots selected by the SUB_BITS leading bits.
+        static constexpr int index_of(uint64_t v) noexcept
+        {
+            const int msb = 63 - std::countl_zero(v | 1);
+            const int shift = std::max(0, msb - (SUB_BITS - 1));
+            return shift * HALF + static_cast<int>(v >> shift);
+        }
+
+        static constexpr uint64_t lower_bound_of(int i) noexcept
+        {
+            if (i < SUB_BUCKETS) return static_cast<uint64_t>(i);
+            const int shift = i / HALF - 1;
+            return static_cast<uint64_t>(i - shift * HALF) << shift;
+        }
+
+        static constexpr uint64_t upper_bound_of(int i) noexcept
+        {
+            if (i < SUB_BUCKETS) return static_cast<uint64_t>(i);
+            const int shift = i / HALF - 1;
+            return lower_bound_of(i) + ((uint64_t{ 1 } << shift) - 1);
+        }
+
+        static constexpr double midpoint_of(int i) noexcept
+        {
+            return (static_cast<double>(lower_bound_of(i)) + static_cast<double>(upper_bound_of(i))) / 2;
+        }
+
+        std::array<uint64_t, NUM_BUCKETS> counts_{};
+        uint64_t total_ = 0;
+        uint64_t max_ = 0;
+        uint64_t min_ = UINT64_MAX;
+    };
+
+    // Write h as an HdrHistogram percentile distribution (.hgrm text, as
+    // plotted by the HdrHistogram tools), dividing values by `scale`
+    // (e.g. TSC ticks per nanosecond).
+    inline void write_percentiles(std::FILE* f, const LatencyHistogram& h, double scale = 1)
+    {
+        std::println(f, "{:>12s} {:>14s} {:>10s} {:>14s}\n", "Value", "Percentile", "TotalCount", "1/(1-Percentile)");
+        const double total = static_cast<double>(h.count());
+        uint64_t seen = 0;
+        h.for_each_bucket([&](uint64_t, uint64_t high, uint64_t n) {
+            seen += n;
+            const double q = seen / total;
+            const double value = static_cast<double>(std::min(high, h.max())) / scale;
+            if (seen < h.count())
+                std::println(f, "{:12.3f} {:14.12f} {:10d} {:14.2f}", value, q, seen, 1 / (1 - q));
+            else
+                std::println(f, "{:12.3f} {:14.12f} {:10d}", value, q, seen);
+        });
+        std::println(f, "#[Mean    = {:12.3f}, Max            = {:12.3f}]", h.mean() / scale, h.max() / scale);
+        std::println(f, "#[Min     = {:12.3f}, Total count    = {:12d}]", h.min() / scale, h.count());
+        std::println(f, "#[Buckets = {:12d}, SubBuckets     = {:12d}]", LatencyHistogram::NUM_BUCKETS, LatencyHistogram::SUB_BUCKETS);
+    }
+
+} // namespace poker
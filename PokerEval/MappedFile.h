@@ -0,0 +1,231 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/****************************************************************
+    Memory-mapped file
+
+    Read-only or read-write mapping of a whole file, plus create()
+    for writers that know their output size up front and resize()
+    for writers that append. Failures throw std::runtime_error
+    with the path and the operation that failed.
+****************************************************************/
+
+namespace poker {
+
+    class MappedFile {
+    public:
+        enum class Mode { Read, ReadWrite };
+
+        MappedFile() = default;
+
+        static MappedFile open(const std::string& path, Mode mode = Mode::Read)
+        {
+            MappedFile f;
+            f.path_ = path;
+            f.writable_ = (mode == Mode::ReadWrite);
+            f.open_handle(false);
+            f.map(f.file_size());
+            return f;
+        }
+
+        // Create (or truncate) a file of exactly `size` bytes and map it read-write.
+        static MappedFile create(const std::string& path, size_t size)
+        {
+            MappedFile f;
+            f.path_ = path;
+            f.writable_ = true;
+            f.open_handle(true);
+            f.set_file_size(size);
+            f.map(size);
+            return f;
+        }
+
+        MappedFile(MappedFile&& other) noexcept { swap(other); }
+        MappedFile& operator=(MappedFile&& other) noexcept
+        {
+            if (this != &other) {
+                close();
+                swap(other);
+            }
+            return *this;
+        }
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        ~MappedFile() { close(); }
+
+        [[nodiscard]] char* data() noexcept { return data_; }
+        [[nodiscard]] const char* data() const noexcept { return data_; }
+        [[nodiscard]] size_t size() const noexcept { return size_; }
+        [[nodiscard]] bool writable() const noexcept { return writable_; }
+        [[nodiscard]] const std::string& path() const noexcept { return path_; }
+
+        // Grow or shrink the file and remap it. Pointers into the old mapping are invalidated.
+        void resize(size_t size)
+        {
+            if (!writable_) fail("resize (read-only mapping)");
+            unmap();
+            set_file_size(size);
+            map(size);
+        }
+
+        // Hint that the mapping will be read front to back.
+        void advise_sequential() noexcept
+        {
+#ifndef _WIN32
+            if (data_) madvise(data_, size_, MADV_SEQUENTIAL);
+#endif
+        }
+
+        // Flush dirty pages to the file.
+        void flush()
+        {
+            if (!data_) return;
+#ifdef _WIN32
+            if (!FlushViewOfFile(data_, 0)) fail("flush");
+#else
+            if (msync(data_, size_, MS_SYNC) != 0) fail("flush");
+#endif
+        }
+
+    private:
+        [[noreturn]] void fail(const char* what) const
+        {
+            throw std::runtime_error("MappedFile: " + std::string(what) + " failed for '" + path_ + "'");
+        }
+
+        void swap(MappedFile& o) noexcept
+        {
+            std::swap(path_, o.path_);
+            std::swap(data_, o.data_);
+            std::swap(size_, o.size_);
+            std::swap(writable_, o.writable_);
+#ifdef _WIN32
+            std::swap(file_, o.file_);
+            std::swap(mapping_, o.mapping_);
+#else
+            std::swap(fd_, o.fd_);
+#endif
+        }
+
+#ifdef _WIN32
+        void open_handle(bool create)
+        {
+            file_ = CreateFileA(path_.c_str(),
+                writable_ ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+                FILE_SHARE_READ, nullptr, create ? CREATE_ALWAYS : OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (file_ == INVALID_HANDLE_VALUE) fail("open");
+        }
+
+        size_t file_size() const
+        {
+            LARGE_INTEGER sz;
+            if (!GetFileSizeEx(file_, &sz)) fail("stat");
+            return static_cast<size_t>(sz.QuadPart);
+        }
+
+        void set_file_size(size_t size)
+        {
+            LARGE_INTEGER pos;
+            pos.QuadPart = static_cast<LONGLONG>(size);
+            if (!SetFilePointerEx(file_, pos, nullptr, FILE_BEGIN) || !SetEndOfFile(file_))
+                fail("resize");
+        }
+
+        void map(size_t size)
+        {
+            size_ = size;
+            if (size == 0) return;
+            mapping_ = CreateFileMappingA(file_, nullptr, writable_ ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+            if (!mapping_) fail("map");
+            data_ = static_cast<char*>(MapViewOfFile(mapping_, writable_ ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size));
+            if (!data_) fail("map");
+        }
+
+        void unmap() noexcept
+        {
+            if (data_) UnmapViewOfFile(data_);
+            if (mapping_) CloseHandle(mapping_);
+            data_ = nullptr;
+            mapping_ = nullptr;
+            size_ = 0;
+        }
+
+        void close() noexcept
+        {
+            unmap();
+            if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+            file_ = INVALID_HANDLE_VALUE;
+        }
+
+        HANDLE file_ = INVALID_HANDLE_VALUE;
+        HANDLE mapping_ = nullptr;
+#else
+        void open_handle(bool create)
+        {
+            const int flags = writable_ ? (O_RDWR | (create ? (O_CREAT | O_TRUNC) : 0)) : O_RDONLY;
+            fd_ = ::open(path_.c_str(), flags, 0644);
+            if (fd_ < 0) fail("open");
+        }
+
+        size_t file_size() const
+        {
+            struct stat st;
+            if (fstat(fd_, &st) != 0) fail("stat");
+            return static_cast<size_t>(st.st_size);
+        }
+
+        void set_file_size(size_t size)
+        {
+            if (ftruncate(fd_, static_cast<off_t>(size)) != 0) fail("resize");
+        }
+
+        void map(size_t size)
+        {
+            size_ = size;
+            if (size == 0) return;
+            void* p = mmap(nullptr, size, writable_ ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd_, 0);
+            if (p == MAP_FAILED) fail("map");
+            data_ = static_cast<char*>(p);
+        }
+
+        void unmap() noexcept
+        {
+            if (data_) munmap(data_, size_);
+            data_ = nullptr;
+            size_ = 0;
+        }
+
+        void close() noexcept
+        {
+            unmap();
+            if (fd_ >= 0) ::close(fd_);
+            fd_ = -1;
+        }
+
+        int fd_ = -1;
+#endif
+
+        std::string path_;
+        char* data_ = nullptr;
+        size_t size_ = 0;
+        bool writable_ = false;
+    };
+
+} // namespace poker
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Poker.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/****************************************************************
+    NUMA helpers
+
+    On Linux the topology is read from /sys/devices/system/node,
+    so no libnuma is needed. Memory for a node is mapped, bound to
+    that node with mbind() when the kernel allows it, and first
+    touched by a thread pinned to the node's CPUs, so pages land
+    locally even if mbind() is unavailable. Other platforms report
+    a single node holding every CPU.
+****************************************************************/
+
+namespace poker {
+
+    struct NumaNode {
+        int id = 0;
+        std::vector<unsigned> cpus;
+    };
+
+    namespace numa_detail {
+
+        // Parse a sysfs cpulist such as "0-7,16-23".
+        inline std::vector<unsigned> parse_cpulist(const std::string& list)
+        {
+            std::vector<unsigned> cpus;
+            size_t pos = 0;
+            while (pos < list.size()) {
+                size_t comma = list.find(',', pos);
+                if (comma == std::string::npos) comma = list.size();
+                const std::string item = list.substr(pos, comma - pos);
+                if (!item.empty() && item[0] >= '0' && item[0] <= '9') {
+                    const size_t dash = item.find('-');
+                    const unsigned lo = static_cast<unsigned>(std::stoul(item.substr(0, dash)));
+                    const unsigned hi = dash == std::string::npos ? lo
+                        : static_cast<unsigned>(std::stoul(item.substr(dash + 1)));
+                    for (unsigned c = lo; c <= hi; ++c)
+                        cpus.push_back(c);
+                }
+                pos = comma + 1;
+            }
+            return cpus;
+        }
+
+        inline std::vector<NumaNode> single_node()
+        {
+            NumaNode node;
+            const unsigned n = std::max(1u, std::thread::hardware_concurrency());
+            for (unsigned c = 0; c < n; ++c)
+                node.cpus.push_back(c);
+            return { node };
+        }
+
+    } // namespace numa_detail
+
+    // Nodes that have CPUs attached, in id order.
+    [[nodiscard]] inline std::vector<NumaNode> numa_topology()
+    {
+#ifdef _WIN32
+        return numa_detail::single_node();
+#else
+        std::ifstream online("/sys/devices/system/node/online");
+        std::string ids;
+        std::getline(online, ids);
+
+        std::vector<NumaNode> nodes;
+        for (unsigned id : numa_detail::parse_cpulist(ids)) {
+            std::ifstream in("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist");
+            std::string list;
+            std::getline(in, list);
+            NumaNode node{ static_cast<int>(id), numa_detail::parse_cpulist(list) };
+            if (!node.cpus.empty())
+                nodes.push_back(std::move(node));
+        }
+        return nodes.empty() ? numa_detail::single_node() : nodes;
+#endif
+    }
+
+    // Restrict the calling thread to the given CPUs.
+    inline bool pin_current_thread(const std::vector<unsigned>& cpus) noexcept
+    {
+#ifdef _WIN32
+        DWORD_PTR mask = 0;
+        for (unsigned c : cpus)
+            if (c < 64) mask |= DWORD_PTR{ 1 } << c;
+        return mask && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#else
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (unsigned c : cpus)
+            if (c < CPU_SETSIZE) CPU_SET(c, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#endif
+    }
+
+    // Map `bytes` of memory intended for `node`. Pages are not touched here:
+    // the caller must first-touch them from a thread running on that node.
+    [[nodiscard]] inline void* numa_alloc(size_t bytes, int node) noexcept
+    {
+#ifdef _WIN32
+        (void)node;
+        return VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) return nullptr;
+#ifdef SYS_mbind
+        // MPOL_BIND = 2. Best effort; first-touch placement still applies if refused.
+        if (node >= 0 && node < 63) {
+            const unsigned long mask = 1UL << node;
+            syscall(SYS_mbind, p, bytes, 2, &mask, 64UL, 0U);
+        }
+#endif
+        return p;
+#endif
+    }
+
+    inline void numa_free(void* p, size_t bytes) noexcept
+    {
+        if (!p) return;
+#ifdef _WIN32
+        (void)bytes;
+        VirtualFree(p, 0, MEM_RELEASE);
+#else
+        munmap(p, bytes);
+#endif
+    }
+
+    // Run fn(worker, num_workers) on one thread per CPU of the node and wait.
+    template<typename Fn>
+    void run_on_node(const NumaNode& node, Fn&& fn)
+    {
+        const unsigned n = static_cast<unsigned>(node.cpus.size());
+        std::vector<std::thread> threads;
+        threads.reserve(n);
+        for (unsigned w = 0; w < n; ++w) {
+            threads.emplace_back([&fn, &node, w, n] {
+                pin_current_thread({ node.cpus[w] });
+                fn(w, n);
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+    }
+
+    // A private copy of the evaluator tables in memory local to one node.
+    class NodeTables {
+    public:
+        explicit NodeTables(const NumaNode& node)
+            : bytes_(sizeof(flushes) + sizeof(unique5) + sizeof(hash_adjust) + sizeof(hash_values)),
+              block_(static_cast<uint16_t*>(numa_alloc(bytes_, node.id)))
+        {
+            if (!block_) {
+                tables_ = default_tables;
+                return;
+            }
+
+            uint16_t* f = block_;
+            uint16_t* u = f + flushes.size();
+            uint16_t* a = u + unique5.size();
+            uint16_t* h = a + hash_adjust.size();
+
+            // Copy from a thread on the node so the replica is first-touched there.
+            std::thread copier([=, &node] {
+                pin_current_thread(node.cpus);
+                std::memcpy(f, flushes.data(), sizeof(flushes));
+                std::memcpy(u, unique5.data(), sizeof(unique5));
+                std::memcpy(a, hash_adjust.data(), sizeof(hash_adjust));
+                std::memcpy(h, hash_values.data(), sizeof(hash_values));
+            });
+            copier.join();
+
+            tables_ = { f, u, a, h };
+        }
+
+        ~NodeTables() { numa_free(block_, bytes_); }
+
+        NodeTables(const NodeTables&) = delete;
+        NodeTables& operator=(const NodeTables&) = delete;
+
+        [[nodiscard]] const TableSet& tables() const noexcept { return tables_; }
+
+    private:
+        size_t bytes_;
+        uint16_t* block_;
+        TableSet tables_{};
+    };
+
+} // namespace poker
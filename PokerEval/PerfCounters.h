@@ -0,0 +1,163 @@
+#pragma once
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#ifdef __linux__
+#include <fstream>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/****************************************************************
+    Hardware performance counters
+
+    Linux perf_event_open counters for the calling thread and every
+    thread it starts afterwards (inherit), so a ThreadPool created
+    after the counters are opened is counted too. Take a snapshot
+    before and after a phase and subtract:
+
+        PerfCounters perf;
+        const PerfSnapshot before = perf.read();
+        ... phase ...
+        const PerfSnapshot delta = perf.read() - before;
+
+    Each event is opened on its own, so an event the CPU or the
+    hypervisor does not offer is reported as missing instead of
+    failing the whole set. When the kernel has to multiplex more
+    events than the PMU has counters, counts are scaled by time
+    enabled / time running. User-space events only.
+
+    Elsewhere, or when perf_event_paranoid forbids it, available()
+    is false and reason() says why.
+****************************************************************/
+
+namespace poker {
+
+    enum class PerfEvent : int {
+        Cycles,
+        Instructions,
+        L1dMisses,
+        LlcMisses,
+        BranchMisses,
+        DtlbMisses,
+    };
+
+    inline constexpr int NUM_PERF_EVENTS = 6;
+
+    inline constexpr std::array<std::string_view, NUM_PERF_EVENTS> perf_event_names = {
+        "cycles", "instructions", "L1d_misses", "LLC_misses", "branch_misses", "dTLB_misses"
+    };
+
+    struct PerfSnapshot {
+        std::array<double, NUM_PERF_EVENTS> counts{};
+        std::array<bool, NUM_PERF_EVENTS> valid{};
+
+        [[nodiscard]] bool has(PerfEvent e) const noexcept { return valid[static_cast<int>(e)]; }
+        [[nodiscard]] double operator[](PerfEvent e) const noexcept { return counts[static_cast<int>(e)]; }
+
+        friend PerfSnapshot operator-(const PerfSnapshot& a, const PerfSnapshot& b) noexcept
+        {
+            PerfSnapshot d;
+            for (int i = 0; i < NUM_PERF_EVENTS; ++i) {
+                d.valid[i] = a.valid[i] && b.valid[i];
+                d.counts[i] = d.valid[i] ? a.counts[i] - b.counts[i] : 0;
+            }
+            return d;
+        }
+    };
+
+    class PerfCounters {
+    public:
+        PerfCounters()
+        {
+            fds_.fill(-1);
+#ifdef __linux__
+            constexpr auto cache_miss = [](uint64_t cache) {
+                return cache | (uint64_t{ PERF_COUNT_HW_CACHE_OP_READ } << 8)
+                             | (uint64_t{ PERF_COUNT_HW_CACHE_RESULT_MISS } << 16);
+            };
+            const std::array<std::pair<uint32_t, uint64_t>, NUM_PERF_EVENTS> events = { {
+                { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+                { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+                { PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_L1D) },
+                { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+                { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+                { PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_DTLB) },
+            } };
+
+            int error = 0;
+            for (int i = 0; i < NUM_PERF_EVENTS; ++i) {
+                perf_event_attr attr{};
+                attr.size = sizeof(attr);
+                attr.type = events[i].first;
+                attr.config = events[i].second;
+                attr.inherit = 1;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+                fds_[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+                if (fds_[i] < 0) error = errno;
+            }
+
+            if (!available()) {
+                reason_ = std::string("perf_event_open failed: ") + std::strerror(error);
+                std::ifstream paranoid("/proc/sys/kernel/perf_event_paranoid");
+                int level;
+                if (paranoid >> level)
+                    reason_ += " (perf_event_paranoid = " + std::to_string(level) + ")";
+            }
+#else
+            reason_ = "hardware counters need Linux perf_event_open";
+#endif
+        }
+
+        ~PerfCounters()
+        {
+#ifdef __linux__
+            for (int fd : fds_)
+                if (fd >= 0) close(fd);
+#endif
+        }
+
+        PerfCounters(const PerfCounters&) = delete;
+        PerfCounters& operator=(const PerfCounters&) = delete;
+
+        // True if at least one event could be opened
+        [[nodiscard]] bool available() const noexcept
+        {
+            for (int fd : fds_)
+                if (fd >= 0) return true;
+            return false;
+        }
+
+        [[nodiscard]] bool has(PerfEvent e) const noexcept { return fds_[static_cast<int>(e)] >= 0; }
+        [[nodiscard]] const std::string& reason() const noexcept { return reason_; }
+
+        // Current counts since the counters were opened
+        [[nodiscard]] PerfSnapshot read() const noexcept
+        {
+            PerfSnapshot s;
+#ifdef __linux__
+            for (int i = 0; i < NUM_PERF_EVENTS; ++i) {
+                uint64_t v[3];      // value, time enabled, time running
+                if (fds_[i] < 0 || ::read(fds_[i], v, sizeof(v)) != sizeof(v)) continue;
+                s.valid[i] = true;
+                s.counts[i] = v[2] ? static_cast<double>(v[0]) * static_cast<double>(v[1]) / static_cast<double>(v[2]) : 0;
+            }
+#endif
+            return s;
+        }
+
+    private:
+        std::array<int, NUM_PERF_EVENTS> fds_;
+        std::string reason_;
+    };
+
+} // namespace poker
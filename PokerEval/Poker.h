@@ -107,10 +107,59 @@ namespace poker {
     }
 
     void print_hand(Hand hand);
-    [[nodiscard]] constexpr unsigned find_fast(unsigned u) noexcept;
 
+    // Instrumentation policy for eval_5cards / eval_7hand, told which path
+    // every evaluation takes. This default does nothing and compiles away;
+    // EvalCounters (EvalCounters.h) counts the paths per thread.
+    struct NoCounters {
+        static constexpr void on_flush(uint32_t) noexcept {}           // flushes[qbits]: flush or straight flush
+        static constexpr void on_unique5(uint32_t) noexcept {}         // unique5[qbits]: straight or high card
+        static constexpr void on_hash(unsigned) noexcept {}            // hash_values[index]: everything else
+        static constexpr void on_7hand(int, bool) noexcept {}          // subsets evaluated, best == 1 early exit
+    };
 
-    [[nodiscard]] constexpr unsigned short eval_5cards(int c1, int c2, int c3, int c4, int c5) noexcept
+    // Pointers to the four lookup tables, so a caller can evaluate against a
+    // relocated copy (e.g. a per-NUMA-node replica) instead of the globals.
+    struct TableSet {
+        const uint16_t* flushes;
+        const uint16_t* unique5;
+        const uint16_t* hash_adjust;
+        const uint16_t* hash_values;
+    };
+
+    inline constexpr TableSet default_tables = {
+        flushes.data(), unique5.data(), hash_adjust.data(), hash_values.data()
+    };
+
+    // The table-free half of find_fast: the hash_values index is a ^ hash_adjust[b]
+    struct FindFastHalves {
+        unsigned a;
+        unsigned b;
+    };
+
+    [[nodiscard]] constexpr FindFastHalves find_fast_halves(unsigned u) noexcept
+    {
+        u += 0xe91aaa35;
+        u ^= u >> 16;
+        u += u << 8;
+        u ^= u >> 4;
+        return { (u + (u << 2)) >> 19, (u >> 8) & 0x1ff };
+    }
+
+    // Perfect hash of a prime product to its hash_values index
+    [[nodiscard]] constexpr unsigned find_fast(const TableSet& t, unsigned u) noexcept
+    {
+        const FindFastHalves h = find_fast_halves(u);
+        return h.a ^ t.hash_adjust[h.b];
+    }
+
+    [[nodiscard]] constexpr unsigned find_fast(unsigned u) noexcept
+    {
+        return find_fast(default_tables, u);
+    }
+
+    template<typename Counters = NoCounters>
+    [[nodiscard]] constexpr unsigned short eval_5cards(const TableSet& t, int c1, int c2, int c3, int c4, int c5) noexcept
     {
         // Rank bitmask for unique5/flushes index
         const uint32_t qbits = (c1 | c2 | c3 | c4 | c5) >> 16;
@@ -119,43 +168,71 @@ namespace poker {
         const uint32_t suit_mask = (c1 & c2 & c3 & c4 & c5) & 0xF000;
 
         // Straights & high-card (unique5 non-zero only in those cases)
-        if (uint16_t s = unique5[qbits]; s != 0) 
+        if (uint16_t s = t.unique5[qbits]; s != 0)
         {
             // Straight flush? Only if all suits match.
-            if (suit_mask) return flushes[qbits];
+            if (suit_mask) {
+                Counters::on_flush(qbits);
+                return t.flushes[qbits];
+            }
+            Counters::on_unique5(qbits);
             return s;
         }
 
-        int q = qbits;
         // Perfect-hash lookup for remaining hands
-        q = (c1 & 0xff) * (c2 & 0xff) * (c3 & 0xff) * (c4 & 0xff) * (c5 & 0xff);
-        return hash_values[find_fast(q)];
+        const unsigned q = (c1 & 0xff) * (c2 & 0xff) * (c3 & 0xff) * (c4 & 0xff) * (c5 & 0xff);
+        const unsigned index = find_fast(t, q);
+        Counters::on_hash(index);
+        return t.hash_values[index];
+    }
+
+    template<typename Counters = NoCounters>
+    [[nodiscard]] constexpr unsigned short eval_5cards(int c1, int c2, int c3, int c4, int c5) noexcept
+    {
+        return eval_5cards<Counters>(default_tables, c1, c2, c3, c4, c5);
     }
 
     // Evaluate the best five-card hand from seven cards
-   // Uses brute-force enumeration of all 21 combinations
-    inline unsigned short eval_7hand(Hand hand)
+    // Uses brute-force enumeration of all 21 combinations
+    template<typename Counters = NoCounters>
+    [[nodiscard]] constexpr unsigned short eval_7hand(const TableSet& t, Hand hand) noexcept
     {
         unsigned short best = 9999;
+        int evaluated = 0;
 
         for (const auto& perm : perm7)
         {
-            unsigned short q = eval_5cards(
-                hand[perm[0]],
-                hand[perm[1]],
-                hand[perm[2]],
-                hand[perm[3]],
-                hand[perm[4]]
-            );
+            unsigned short q = eval_5cards<Counters>(t,
+                hand[perm[0]], hand[perm[1]], hand[perm[2]], hand[perm[3]], hand[perm[4]]);
+            ++evaluated;
 
             if (q < best)
                 best = q;
-            if (best == 1)
+            if (best == 1) {
+                Counters::on_7hand(evaluated, true);
                 return 1;  // Royal Flush found
+            }
         }
+        Counters::on_7hand(evaluated, false);
         return best;
     }
 
+    template<typename Counters = NoCounters>
+    [[nodiscard]] constexpr unsigned short eval_7hand(Hand hand) noexcept
+    {
+        return eval_7hand<Counters>(default_tables, hand);
+    }
+
+    [[nodiscard]] constexpr unsigned short eval_5hand(const TableSet& t, Hand hand) noexcept
+    {
+        return eval_5cards(t, hand[0], hand[1], hand[2], hand[3], hand[4]);
+    }
+
+    [[nodiscard]] constexpr unsigned short eval_5hand(Hand hand) noexcept
+    {
+        return eval_5hand(default_tables, hand);
+    }
+
 
     // Constexpr function definitions (must be in header)
     [[nodiscard]] constexpr Deck init_deck() noexcept
@@ -196,21 +273,44 @@ namespace poker {
         return STRAIGHT_FLUSH;                   //   10 straight-flushes
     }
 
-    [[nodiscard]] constexpr unsigned find_fast(unsigned u) noexcept
+    // Branch-free variants for unpredictable input. eval_5cards branches on
+    // unique5 and on the suit test, which random hands mispredict about as
+    // often as not; these make all three lookups and pick the value with
+    // masks. eval_7hand_branchless scores all 21 subsets with no early exit.
+    // Where categories come in runs the branchy versions are faster, so the
+    // choice is left to each call site.
+    [[nodiscard]] inline unsigned short eval_5cards_branchless(const TableSet& t, int c1, int c2, int c3, int c4, int c5) noexcept
     {
-        u += 0xe91aaa35;
-        u ^= u >> 16;
-        u += u << 8;
-        u ^= u >> 4;
-        unsigned b = (u >> 8) & 0x1ff;
-        unsigned a = (u + (u << 2)) >> 19;
-        unsigned r = a ^ hash_adjust[b];
-        return r;
+        const uint32_t qbits = (c1 | c2 | c3 | c4 | c5) >> 16;
+        const unsigned q = (c1 & 0xff) * (c2 & 0xff) * (c3 & 0xff) * (c4 & 0xff) * (c5 & 0xff);
+
+        const uint32_t s = t.unique5[qbits];
+        const uint32_t f = t.flushes[qbits];
+        const uint32_t h = t.hash_values[find_fast(t, q)];
+
+        const uint32_t use_s = 0u - static_cast<uint32_t>(s != 0);
+        const uint32_t use_f = 0u - static_cast<uint32_t>(((c1 & c2 & c3 & c4 & c5) & 0xF000) != 0);
+        const uint32_t v = (s & use_s) | (h & ~use_s);
+        return static_cast<unsigned short>((f & use_f) | (v & ~use_f));
     }
 
-    [[nodiscard]] constexpr unsigned short eval_5hand(Hand hand) noexcept
+    [[nodiscard]] inline unsigned short eval_5cards_branchless(int c1, int c2, int c3, int c4, int c5) noexcept
+    {
+        return eval_5cards_branchless(default_tables, c1, c2, c3, c4, c5);
+    }
+
+    [[nodiscard]] inline unsigned short eval_7hand_branchless(const TableSet& t, Hand hand) noexcept
+    {
+        unsigned short best = 9999;
+        for (const auto& perm : perm7)
+            best = std::min(best, eval_5cards_branchless(t,
+                hand[perm[0]], hand[perm[1]], hand[perm[2]], hand[perm[3]], hand[perm[4]]));
+        return best;
+    }
+
+    [[nodiscard]] inline unsigned short eval_7hand_branchless(Hand hand) noexcept
     {
-        return eval_5cards(hand[0], hand[1], hand[2], hand[3], hand[4]);
+        return eval_7hand_branchless(default_tables, hand);
     }
 
 } // namespace poker
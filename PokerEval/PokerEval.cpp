@@ -5,8 +5,10 @@
 #include <chrono>
 #include <array>
 #include <ranges>
+#include <thread>
 #include "Poker.h"
 #include "arrays.h"
+#include "Exhaustive.h"
 
 /****************************************************************
     This code tests the evaluator by looping over all 2,598,960
@@ -15,6 +17,11 @@
     hand type. It also prints the amount of time taken to
     perform all the calculations.
 
+    It then sweeps all 133,784,560 seven-card hands across all
+    cores and checks both the category counts and the full
+    7462-class histogram against the reference. The process
+    exits non-zero if either check fails.
+
     Kevin L. Suffecool (a.k.a "Cactus Kev"), 2001
     kevin@suffe.cool
 
@@ -94,6 +101,41 @@ int main()
     std::println("\nElapsed time: {:.4f} (msecs)",
         elapsed.count() / 1000.0);
 
-    return 0;
+    bool ok = (freq == expected_freq);
+
+    // Exhaustive 7-card sweep.
+    const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::println("\nSweeping all {} seven-card hands on {} threads...",
+        TOTAL_7CARD_HANDS, threads);
+
+    start = steady_clock::now();
+    const SweepResult sweep = sweep_7cards(
+        [](std::span<const int, 7> h) { return eval_7hand(h); }, threads);
+    end = steady_clock::now();
+
+    for (int i : std::views::iota(1, 10))
+    {
+        std::print("{:>15s}: {:9d}", value_str[i], sweep.categories[i]);
+        if (sweep.categories[i] != expected_freq7[i])
+        {
+            std::println(" (expected {})", expected_freq7[i]);
+        }
+        else {
+            std::println("");
+        }
+    }
+    std::println("{:>15s}: {:9d} (expected {})", "Distinct values",
+        sweep.distinct, EXPECTED_DISTINCT_7CARD_VALUES);
+    std::println("{:>15s}: {:#018x} (expected {:#018x})", "Fingerprint",
+        sweep.fingerprint, EXPECTED_7CARD_FINGERPRINT);
+
+    elapsed = duration_cast<microseconds>(end - start);
+    std::println("\nElapsed time: {:.4f} (msecs), {:.2f}M hands/sec",
+        elapsed.count() / 1000.0, sweep.total / static_cast<double>(elapsed.count()));
+
+    ok = ok && sweep_matches_reference(sweep);
+    std::println("\n{}", ok ? "PASS" : "FAIL");
+
+    return ok ? 0 : 1;
 }
 
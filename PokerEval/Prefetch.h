@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "Poker.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+/****************************************************************
+    Software-prefetching batch evaluation
+
+    eval_5cards makes dependent loads: unique5[qbits] (or
+    flushes[qbits]), and for the rest hash_adjust[b] and then
+    hash_values[a ^ hash_adjust[b]]. One hand at a time the core
+    waits on every miss in that chain. The pipelined loops below
+    keep `lookahead` hands in flight:
+
+        stage 1, hand i + lookahead     keys from the cards;
+                                        prefetch unique5, flushes,
+                                        hash_adjust
+        stage 2, hand i + lookahead/2   hash_values index from
+                                        hash_adjust; prefetch it
+        stage 3, hand i                 the value, from lines
+                                        that should now be cached
+
+        unsigned long long sum = 0;
+        eval_5cards_pipelined(hands, count, 8,
+            [&](size_t i, unsigned short v) { sum += v; });
+
+    A lookahead of 0 is the plain scalar loop. The right distance
+    depends on miss latency and on the work per hand, so it is a
+    run-time argument; Benchmark --mode prefetch sweeps it. The
+    Cactus Kev tables fit in L1, so there is no miss to hide: the
+    pipeline hashes every hand, even those unique5 settles, which
+    the scalar loop skips. Tables that miss to L3 or DRAM are what
+    it is for.
+****************************************************************/
+
+namespace poker {
+
+    inline constexpr int MAX_LOOKAHEAD = 32;
+    inline constexpr int DEFAULT_LOOKAHEAD = 8;
+
+    inline void prefetch(const void* p) noexcept
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#elif defined(__GNUC__)
+        __builtin_prefetch(p, 0, 3);
+#else
+        (void)p;
+#endif
+    }
+
+    namespace prefetch_detail {
+
+        inline constexpr size_t RING = 2 * MAX_LOOKAHEAD;     // power of two, > lookahead
+
+        // A five-card evaluation between stages, packed into 8 bytes
+        struct Pending {
+            uint16_t qbits;         // rank bits, the unique5 / flushes index
+            uint16_t suited;        // all five cards of one suit
+            uint16_t a;             // find_fast_halves; after stage 2, a is
+            uint16_t b;             // the hash_values index a ^ hash_adjust[b]
+        };
+
+        inline void stage1(Pending& p, const TableSet& t, int c1, int c2, int c3, int c4, int c5) noexcept
+        {
+            p.qbits = static_cast<uint16_t>(static_cast<uint32_t>(c1 | c2 | c3 | c4 | c5) >> 16);
+            p.suited = (c1 & c2 & c3 & c4 & c5 & 0xF000) != 0;
+
+            const FindFastHalves h = find_fast_halves(
+                static_cast<unsigned>((c1 & 0xff) * (c2 & 0xff) * (c3 & 0xff) * (c4 & 0xff) * (c5 & 0xff)));
+            p.a = static_cast<uint16_t>(h.a);
+            p.b = static_cast<uint16_t>(h.b);
+
+            prefetch(t.unique5 + p.qbits);
+            if (p.suited) prefetch(t.flushes + p.qbits);
+            prefetch(t.hash_adjust + p.b);
+        }
+
+        inline void stage2(Pending& p, const TableSet& t) noexcept
+        {
+            p.a ^= t.hash_adjust[p.b];
+            prefetch(t.hash_values + p.a);
+        }
+
+        // Both candidate values are loaded so the unique5 test can become a
+        // conditional move; the lines are cached by now.
+        [[nodiscard]] inline unsigned short stage3(const Pending& p, const TableSet& t) noexcept
+        {
+            const uint16_t s = t.unique5[p.qbits];
+            const uint16_t h = t.hash_values[p.a];
+            if (p.suited) return s ? t.flushes[p.qbits] : h;
+            return s ? s : h;
+        }
+
+        // Software pipeline over `count` items, `lookahead` (>= 1) apart:
+        // first(k, item) computes keys and prefetches, second(item) follows
+        // one dependent load and prefetches again, finish(k, item) is called
+        // for every item in order.
+        template<typename Item, typename First, typename Second, typename Finish>
+        void pipeline(size_t count, int lookahead, First&& first, Second&& second, Finish&& finish) noexcept
+        {
+            const size_t far = static_cast<size_t>(std::clamp(lookahead, 1, MAX_LOOKAHEAD));
+            const size_t near = far / 2;
+            std::array<Item, RING> ring;
+
+            for (size_t k = 0; k < std::min(far, count); ++k)
+                first(k, ring[k % RING]);
+            for (size_t k = 0; k < std::min(near, count); ++k)
+                second(ring[k % RING]);
+
+            for (size_t i = 0; i < count; ++i) {
+                if (i + far < count) first(i + far, ring[(i + far) % RING]);
+                if (i + near < count) second(ring[(i + near) % RING]);
+                finish(i, ring[i % RING]);
+            }
+        }
+
+    } // namespace prefetch_detail
+
+    // Evaluate `count` five-card hands stored back to back, keeping `lookahead`
+    // hands in flight; sink(i, value) is called for every hand in order.
+    template<typename Sink>
+    void eval_5cards_pipelined(const TableSet& t, const int* hands, size_t count, int lookahead, Sink&& sink) noexcept
+    {
+        using namespace prefetch_detail;
+        if (lookahead <= 0) {
+            for (size_t i = 0; i < count; ++i) {
+                const int* h = hands + i * 5;
+                sink(i, eval_5cards(t, h[0], h[1], h[2], h[3], h[4]));
+            }
+            return;
+        }
+        pipeline<Pending>(count, lookahead,
+            [&](size_t k, Pending& p) {
+                const int* h = hands + k * 5;
+                stage1(p, t, h[0], h[1], h[2], h[3], h[4]);
+            },
+            [&](Pending& p) { stage2(p, t); },
+            [&](size_t k, const Pending& p) { sink(k, stage3(p, t)); });
+    }
+
+    template<typename Sink>
+    void eval_5cards_pipelined(const int* hands, size_t count, int lookahead, Sink&& sink) noexcept
+    {
+        eval_5cards_pipelined(default_tables, hands, count, lookahead, sink);
+    }
+
+    // Seven-card hands: each stage handles all 21 five-card subsets of a
+    // hand, so `lookahead` counts hands and up to 21 * lookahead lookups
+    // are in flight.
+    template<typename Sink>
+    void eval_7hand_pipelined(const TableSet& t, const int* hands, size_t count, int lookahead, Sink&& sink) noexcept
+    {
+        using namespace prefetch_detail;
+        if (lookahead <= 0) {
+            for (size_t i = 0; i < count; ++i)
+                sink(i, eval_7hand(t, Hand{ hands + i * 7, 7 }));
+            return;
+        }
+        using Subsets = std::array<Pending, perm7.size()>;
+        pipeline<Subsets>(count, lookahead,
+            [&](size_t k, Subsets& s) {
+                const int* h = hands + k * 7;
+                for (size_t j = 0; j < perm7.size(); ++j) {
+                    const auto& perm = perm7[j];
+                    stage1(s[j], t, h[perm[0]], h[perm[1]], h[perm[2]], h[perm[3]], h[perm[4]]);
+                }
+            },
+            [&](Subsets& s) {
+                for (Pending& p : s)
+                    stage2(p, t);
+            },
+            [&](size_t k, const Subsets& s) {
+                unsigned short best = 9999;
+                for (const Pending& p : s)
+                    best = std::min(best, stage3(p, t));
+                sink(k, best);
+            });
+    }
+
+    template<typename Sink>
+    void eval_7hand_pipelined(const int* hands, size_t count, int lookahead, Sink&& sink) noexcept
+    {
+        eval_7hand_pipelined(default_tables, hands, count, lookahead, sink);
+    }
+
+} // namespace poker
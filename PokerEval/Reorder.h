@@ -0,0 +1,114 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Poker.h"
+
+/****************************************************************
+    Locality-aware batch reordering
+
+    A batch of random hands reads the lookup tables at scattered
+    indices. Once a table is far larger than the caches, nearly
+    every hand misses, and beyond the TLB reach it takes a page
+    walk as well. LocalityReorder buckets the hands by table region
+    first, with one counting-sort pass over a key the caller
+    supplies. The evaluator then walks the table region by region,
+    and the results are scattered back to input order:
+
+        LocalityReorder reorder;                // reusable buffers
+        reorder.evaluate(hands, count, 5, 8,
+            [](const int* h) { return kev5_table_key(h) >> (KEV5_KEY_BITS - 8); },
+            [](const int* sorted, size_t n, unsigned short* v) { ... batch evaluator ... },
+            values);                            // values[i] belongs to hand i
+
+    The pass costs a key per hand, a copy of the hands and a
+    scatter of the values, so it pays off only when the lookups it
+    saves miss to L3 or DRAM. Benchmark --mode reorder finds that
+    point.
+****************************************************************/
+
+namespace poker {
+
+    class LocalityReorder {
+    public:
+        // Evaluate `count` hands of `cards` ints in bucket order. bucket(hand)
+        // must return a value below 2^bucket_bits; batch(hands, n, values)
+        // scores n contiguous hands.
+        template<typename BucketFn, typename BatchFn>
+        void evaluate(const int* hands, size_t count, int cards, int bucket_bits,
+                      BucketFn&& bucket, BatchFn&& batch, unsigned short* out)
+        {
+            if (bucket_bits == 0) {         // one bucket: input order already
+                batch(hands, count, out);
+                return;
+            }
+            plan(hands, count, cards, bucket_bits, bucket);
+            values_.resize(count);
+            batch(sorted_.data(), count, values_.data());
+            for (size_t i = 0; i < count; ++i)
+                out[order_[i]] = values_[i];
+        }
+
+        // Counting sort of the hands by bucket into sorted(); order()[i] is
+        // the input position of sorted hand i.
+        template<typename BucketFn>
+        void plan(const int* hands, size_t count, int cards, int bucket_bits, BucketFn&& bucket)
+        {
+            starts_.assign((size_t{ 1 } << bucket_bits) + 1, 0);
+            buckets_.resize(count);
+            for (size_t i = 0; i < count; ++i) {
+                const uint32_t b = static_cast<uint32_t>(bucket(hands + i * cards));
+                buckets_[i] = b;
+                ++starts_[b + 1];
+            }
+            for (size_t b = 1; b < starts_.size(); ++b)
+                starts_[b] += starts_[b - 1];
+
+            sorted_.resize(count * cards);
+            order_.resize(count);
+            switch (cards) {
+            case 5: scatter<5>(hands, count); break;
+            case 7: scatter<7>(hands, count); break;
+            default: scatter<0>(hands, count, cards); break;
+            }
+        }
+
+        [[nodiscard]] const std::vector<int>& sorted() const noexcept { return sorted_; }
+        [[nodiscard]] const std::vector<uint32_t>& order() const noexcept { return order_; }
+
+    private:
+        // Move every hand to its bucket's next slot; a fixed Cards lets the
+        // copy compile to a few moves
+        template<int Cards>
+        void scatter(const int* hands, size_t count, int cards = Cards) noexcept
+        {
+            for (size_t i = 0; i < count; ++i) {
+                const uint32_t pos = starts_[buckets_[i]]++;
+                order_[pos] = static_cast<uint32_t>(i);
+                std::copy_n(hands + i * cards, Cards ? Cards : cards, sorted_.data() + static_cast<size_t>(pos) * cards);
+            }
+        }
+
+        std::vector<uint32_t> starts_;
+        std::vector<uint32_t> buckets_;
+        std::vector<uint32_t> order_;
+        std::vector<int> sorted_;
+        std::vector<unsigned short> values_;
+    };
+
+    // Table key of a five-card hand for Cactus Kev: the unique5 / flushes
+    // index (qbits) for hands those tables settle, 8192 + the hash_values
+    // index for the rest. Its high bits name a table region.
+    inline constexpr int KEV5_KEY_BITS = 14;
+
+    [[nodiscard]] inline uint32_t kev5_table_key(const int* h) noexcept
+    {
+        const uint32_t qbits = static_cast<uint32_t>(h[0] | h[1] | h[2] | h[3] | h[4]) >> 16;
+        if (unique5[qbits]) return qbits;
+        const unsigned q = static_cast<unsigned>((h[0] & 0xff) * (h[1] & 0xff) * (h[2] & 0xff) * (h[3] & 0xff) * (h[4] & 0xff));
+        return 8192 + find_fast(q);
+    }
+
+} // namespace poker
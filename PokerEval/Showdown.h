@@ -0,0 +1,54 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include "Poker.h"
+
+/****************************************************************
+    Multi-way showdown evaluation
+
+    A showdown is a five-card board plus two hole cards for each
+    of up to MAX_SEATS players. Every player's best hand is the
+    eval_7hand value of board + hole cards; the winners are all
+    players sharing the lowest value (ties split the pot).
+****************************************************************/
+
+namespace poker {
+
+    inline constexpr int MAX_SEATS = 10;
+
+    struct Showdown {
+        std::array<int, 5> board{};
+        std::array<std::array<int, 2>, MAX_SEATS> holes{};
+        int players = 0;
+    };
+
+    struct ShowdownResult {
+        std::array<unsigned short, MAX_SEATS> values{};
+        uint16_t winners = 0;        // bit i set if seat i wins or shares the pot
+        unsigned short best = 9999;
+    };
+
+    [[nodiscard]] inline ShowdownResult evaluate_showdown(const Showdown& s) noexcept
+    {
+        ShowdownResult r;
+        std::array<int, 7> hand;
+        std::copy(s.board.begin(), s.board.end(), hand.begin());
+
+        for (int p = 0; p < s.players; ++p) {
+            hand[5] = s.holes[p][0];
+            hand[6] = s.holes[p][1];
+            const unsigned short v = eval_7hand(hand);
+            r.values[p] = v;
+            if (v < r.best) {
+                r.best = v;
+                r.winners = 0;
+            }
+            if (v == r.best)
+                r.winners |= static_cast<uint16_t>(1u << p);
+        }
+        return r;
+    }
+
+} // namespace poker
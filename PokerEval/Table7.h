@@ -0,0 +1,269 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include "Poker.h"
+#include "CardParser.h"
+#include "HugePages.h"
+#include "MappedFile.h"
+#include "Prefetch.h"
+#include "ThreadPool.h"
+
+/****************************************************************
+    Precomputed 7-card table (.p7t)
+
+    Write a hand's deck indices (suit * 13 + rank, as in HandFile)
+    in ascending order, c0 < c1 < ... < c6. Its colex rank is
+
+        C(c0, 1) + C(c1, 2) + ... + C(c6, 7)
+
+    which numbers the C(52,7) = 133,784,560 hands from 0 to N-1
+    with no gaps. Table7 stores eval_7hand of every hand at its
+    rank, 267 MB of uint16_t. A query is then a rank computation
+    and one load.
+
+    Layout, all integers little-endian:
+
+        [0, 64)          Table7Header
+        [64, ...)        uint16_t value of every hand, in rank order
+
+    Table7::write builds a file in parallel, straight into a
+    MappedFile. Table7::open maps the file read-only, so every
+    process shares the page cache. Table7::open(path, Huge) copies
+    it instead into anonymous memory on huge pages: file mappings
+    on ordinary file systems get only 4 KB pages. Table7::build
+    makes the table in memory without a file. Both use PageBuffer
+    (HugePages.h).
+
+    The table is far larger than any cache, so a random query costs
+    a DRAM access, and with 4 KB pages a page walk as well.
+    eval_pipelined keeps `lookahead` queries in flight.
+****************************************************************/
+
+namespace poker {
+
+    inline constexpr char TABLE7_MAGIC[8] = { 'P', 'K', 'T', 'A', 'B', 'L', 'E', '7' };
+    inline constexpr uint16_t TABLE7_VERSION = 1;
+    inline constexpr uint32_t TABLE7_ENTRIES = 133'784'560;
+
+    struct Table7Header {
+        char magic[8];
+        uint16_t version;
+        uint16_t value_bytes;    // sizeof(uint16_t)
+        uint32_t reserved0;
+        uint64_t entries;        // TABLE7_ENTRIES
+        uint64_t values_offset;  // 64
+        uint8_t reserved[32];
+    };
+    static_assert(sizeof(Table7Header) == 64);
+
+    namespace table7_detail {
+
+        // binomial[k][n] = C(n, k) for the k <= 7 the rank needs. Columns
+        // 53..64 are 0, so countr_zero of an emptied mask (64) stays in bounds.
+        inline constexpr auto binomial = [] {
+            std::array<std::array<uint32_t, 65>, 8> c{};
+            for (int n = 0; n <= 52; ++n) {
+                c[0][n] = 1;
+                for (int k = 1; k <= std::min(n, 7); ++k)
+                    c[k][n] = c[k - 1][n - 1] + (k <= n - 1 ? c[k][n - 1] : 0);
+            }
+            return c;
+        }();
+        static_assert(binomial[7][52] == TABLE7_ENTRIES);
+
+        // Deck index of a Cactus Kev card, indexed by its suit and rank
+        // byte (card >> 8): one L1 load instead of decoding the suit bit
+        inline constexpr auto deck_index = [] {
+            std::array<uint8_t, 256> lut{};
+            for (uint8_t i = 0; i < 52; ++i)
+                lut[(card_table[i] >> 8) & 0xFF] = i;
+            return lut;
+        }();
+
+        // Cards of the hand with colex rank `rank`, as ascending deck indices
+        [[nodiscard]] constexpr std::array<uint8_t, 7> unrank(uint32_t rank) noexcept
+        {
+            std::array<uint8_t, 7> c{};
+            int n = 52;
+            for (int k = 7; k >= 1; --k) {
+                do --n; while (binomial[k][n] > rank);
+                c[k - 1] = static_cast<uint8_t>(n);
+                rank -= binomial[k][n];
+            }
+            return c;
+        }
+
+        // Step to the next hand in colex order: raise the lowest card that
+        // can move up and put the ones below it back at 0, 1, ...
+        constexpr void next(std::array<uint8_t, 7>& c) noexcept
+        {
+            int i = 0;
+            while (i < 6 && c[i] + 1 == c[i + 1]) ++i;
+            ++c[i];
+            for (int j = 0; j < i; ++j)
+                c[j] = static_cast<uint8_t>(j);
+        }
+
+        // Ranks per work item when filling the table
+        inline constexpr uint32_t FILL_BLOCK = 1 << 16;
+
+    } // namespace table7_detail
+
+    // Colex rank of seven distinct deck indices in ascending order
+    [[nodiscard]] constexpr uint32_t colex_rank7(std::span<const uint8_t, 7> sorted) noexcept
+    {
+        uint32_t rank = 0;
+        for (int k = 0; k < 7; ++k)
+            rank += table7_detail::binomial[k + 1][sorted[k]];
+        return rank;
+    }
+
+    // Colex rank of seven distinct Cactus Kev cards in any order. A 52-bit
+    // mask sorts them: its set bits come out lowest first. With a repeated
+    // card the mask has fewer bits; the rank is then meaningless but still
+    // below TABLE7_ENTRIES, so a lookup stays inside the table.
+    [[nodiscard]] constexpr uint32_t colex_rank7(const int* cards) noexcept
+    {
+        uint64_t mask = 0;
+        for (int k = 0; k < 7; ++k)
+            mask |= uint64_t{ 1 } << table7_detail::deck_index[(cards[k] >> 8) & 0xFF];
+        assert(std::popcount(mask) == 7 && "colex_rank7: repeated card");
+        uint32_t rank = 0;
+        for (int k = 1; k <= 7; ++k, mask &= mask - 1)
+            rank += table7_detail::binomial[k][std::countr_zero(mask)];
+        return rank;
+    }
+
+    // Write eval_7hand of every hand at its rank into out[0, TABLE7_ENTRIES)
+    inline void fill_table7(uint16_t* out, ThreadPool& pool)
+    {
+        using namespace table7_detail;
+        const size_t blocks = (TABLE7_ENTRIES + FILL_BLOCK - 1) / FILL_BLOCK;
+        pool.parallel_for(blocks, [&](size_t b, size_t e, unsigned) {
+            std::array<int, 7> hand;
+            for (size_t block = b; block < e; ++block) {
+                const uint32_t first = static_cast<uint32_t>(block * FILL_BLOCK);
+                const uint32_t last = std::min(TABLE7_ENTRIES, first + FILL_BLOCK);
+                std::array<uint8_t, 7> c = unrank(first);
+                for (uint32_t r = first; r < last; ++r, next(c)) {
+                    for (int k = 0; k < 7; ++k)
+                        hand[k] = card_table[c[k]];
+                    out[r] = eval_7hand(hand);
+                }
+            }
+        });
+    }
+
+    class Table7 {
+    public:
+        enum class Pages { Mapped, Huge };
+
+        // Build the table into a new file at `path`.
+        static void write(const std::string& path, ThreadPool& pool)
+        {
+            MappedFile file = MappedFile::create(path, sizeof(Table7Header) + size_t{ TABLE7_ENTRIES } * sizeof(uint16_t));
+            Table7Header h{};
+            std::memcpy(h.magic, TABLE7_MAGIC, sizeof(h.magic));
+            h.version = TABLE7_VERSION;
+            h.value_bytes = sizeof(uint16_t);
+            h.entries = TABLE7_ENTRIES;
+            h.values_offset = sizeof(Table7Header);
+            std::memcpy(file.data(), &h, sizeof(h));
+            fill_table7(reinterpret_cast<uint16_t*>(file.data() + sizeof(Table7Header)), pool);
+            file.flush();
+        }
+
+        // Map a file made by write(), or with Pages::Huge copy it into huge pages.
+        static Table7 open(const std::string& path, Pages pages = Pages::Mapped)
+        {
+            Table7 t;
+            t.file_ = MappedFile::open(path);
+            Table7Header h;
+            if (t.file_.size() < sizeof(h))
+                throw std::runtime_error("Table7: '" + path + "' is too short");
+            std::memcpy(&h, t.file_.data(), sizeof(h));
+            if (std::memcmp(h.magic, TABLE7_MAGIC, sizeof(h.magic)) != 0 || h.version != TABLE7_VERSION
+                || h.value_bytes != sizeof(uint16_t) || h.entries != TABLE7_ENTRIES
+                || h.values_offset > t.file_.size()
+                || t.file_.size() - h.values_offset < h.entries * sizeof(uint16_t))
+                throw std::runtime_error("Table7: '" + path + "' is not a 7-card table");
+
+            const auto* values = reinterpret_cast<const uint16_t*>(t.file_.data() + h.values_offset);
+            if (pages == Pages::Mapped) {
+                t.values_ = values;
+                t.backing_ = "file mapping";
+                return t;
+            }
+            t.memory_ = PageBuffer(size_t{ TABLE7_ENTRIES } * sizeof(uint16_t), HugePages::On);
+            std::memcpy(t.memory_.data(), values, size_t{ TABLE7_ENTRIES } * sizeof(uint16_t));
+            t.file_ = MappedFile();
+            t.values_ = static_cast<const uint16_t*>(t.memory_.data());
+            t.backing_ = to_string(t.memory_.backing());
+            return t;
+        }
+
+        // Build the table in memory, without a file.
+        static Table7 build(ThreadPool& pool, HugePages pages = HugePages::On)
+        {
+            Table7 t;
+            t.memory_ = PageBuffer(size_t{ TABLE7_ENTRIES } * sizeof(uint16_t), pages);
+            fill_table7(static_cast<uint16_t*>(t.memory_.data()), pool);
+            t.values_ = static_cast<const uint16_t*>(t.memory_.data());
+            t.backing_ = to_string(t.memory_.backing());
+            return t;
+        }
+
+        [[nodiscard]] std::span<const uint16_t> values() const noexcept { return { values_, TABLE7_ENTRIES }; }
+        [[nodiscard]] size_t bytes() const noexcept { return size_t{ TABLE7_ENTRIES } * sizeof(uint16_t); }
+
+        // Where the values live: "file mapping", "2 MB pages", ...
+        [[nodiscard]] std::string_view backing() const noexcept { return backing_; }
+
+        // Bytes of the table on huge pages (PageBuffer::huge_bytes); 0 for a file mapping
+        [[nodiscard]] size_t huge_bytes() const { return memory_.huge_bytes(); }
+
+        // Value of seven distinct Cactus Kev cards, as eval_7hand would give.
+        // The cards must be distinct: a repeat gives a wrong value (and fails
+        // an assert in debug builds), never a read outside the table.
+        [[nodiscard]] unsigned short eval(const int* cards) const noexcept { return values_[colex_rank7(cards)]; }
+
+        // Evaluate `count` seven-card hands stored back to back, prefetching
+        // `lookahead` hands ahead; sink(i, value) is called for every hand in order.
+        template<typename Sink>
+        void eval_pipelined(const int* hands, size_t count, int lookahead, Sink&& sink) const noexcept
+        {
+            if (lookahead <= 0) {
+                for (size_t i = 0; i < count; ++i)
+                    sink(i, eval(hands + i * 7));
+                return;
+            }
+            prefetch_detail::pipeline<uint32_t>(count, lookahead,
+                [&](size_t k, uint32_t& rank) {
+                    rank = colex_rank7(hands + k * 7);
+                    prefetch(values_ + rank);
+                },
+                [](uint32_t&) {},
+                [&](size_t k, uint32_t rank) { sink(k, values_[rank]); });
+        }
+
+    private:
+        Table7() = default;
+
+        MappedFile file_;
+        PageBuffer memory_;
+        const uint16_t* values_ = nullptr;
+        std::string_view backing_;
+    };
+
+} // namespace poker
@@ -0,0 +1,270 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+#include "Poker.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/****************************************************************
+    Persistent work-stealing worker pool
+
+    Workers are created once and sleep between jobs. A job over
+    [0, n) is split into one contiguous range per worker; each
+    worker carves chunk_size items at a time off the front of its
+    own deque, and once that is empty it steals the back half of
+    the last range left in another worker's deque. Splitting,
+    thread creation and reduction are therefore the same on every
+    platform instead of being left to the std::execution backend.
+****************************************************************/
+
+namespace poker {
+
+    // Pin a thread to one logical CPU. Returns false if the OS refused.
+    inline bool pin_thread(std::thread& thread, unsigned cpu) noexcept
+    {
+#ifdef _WIN32
+        if (cpu >= 64) return false;
+        return SetThreadAffinityMask(thread.native_handle(), DWORD_PTR{ 1 } << cpu) != 0;
+#else
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+#endif
+    }
+
+    struct PoolOptions {
+        unsigned threads = 0;           // 0 = hardware_concurrency()
+        size_t chunk_size = 16 * 1024;  // items taken per deque pop
+        bool pin_threads = false;       // pin worker i to CPU i
+    };
+
+    class ThreadPool {
+    public:
+        explicit ThreadPool(PoolOptions options = {})
+            : chunk_size_(std::max<size_t>(1, options.chunk_size))
+        {
+            unsigned n = options.threads ? options.threads
+                                         : std::max(1u, std::thread::hardware_concurrency());
+            queues_ = std::vector<Queue>(n);
+            workers_.reserve(n);
+            for (unsigned i = 0; i < n; ++i) {
+                workers_.emplace_back([this, i] { run(i); });
+                if (options.pin_threads)
+                    pin_thread(workers_.back(), i);
+            }
+        }
+
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard lock(mutex_);
+                stop_ = true;
+            }
+            wake_.notify_all();
+            for (auto& w : workers_)
+                w.join();
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        [[nodiscard]] unsigned size() const noexcept { return static_cast<unsigned>(workers_.size()); }
+        [[nodiscard]] size_t chunk_size() const noexcept { return chunk_size_; }
+
+        // Call fn(begin, end, worker) over disjoint chunks covering [0, n) and
+        // wait for all of them. Jobs from different threads are serialised.
+        template<typename Fn>
+        void parallel_for(size_t n, Fn&& fn)
+        {
+            if (n == 0) return;
+
+            std::lock_guard job_lock(submit_mutex_);
+
+            // Publish the job before any range becomes visible: a worker still
+            // draining the previous job may pick up a new range straight away.
+            job_ = std::ref(fn);
+            remaining_.store(n, std::memory_order_relaxed);
+
+            const size_t per_worker = (n + size() - 1) / size();
+            for (unsigned i = 0; i < size(); ++i) {
+                const size_t b = std::min(n, i * per_worker);
+                const size_t e = std::min(n, b + per_worker);
+                if (b < e) {
+                    std::lock_guard lock(queues_[i].mutex);
+                    queues_[i].ranges.push_back({ b, e });
+                }
+            }
+
+            {
+                std::lock_guard lock(mutex_);
+                ++generation_;
+            }
+            wake_.notify_all();
+
+            std::unique_lock lock(mutex_);
+            done_.wait(lock, [this] { return remaining_.load(std::memory_order_acquire) == 0; });
+        }
+
+    private:
+        struct Range {
+            size_t begin;
+            size_t end;
+        };
+
+        struct alignas(64) Queue {
+            std::mutex mutex;
+            std::deque<Range> ranges;
+        };
+
+        // Take up to chunk_size_ items from the front of our own deque.
+        bool pop_local(unsigned self, Range& out)
+        {
+            Queue& q = queues_[self];
+            std::lock_guard lock(q.mutex);
+            if (q.ranges.empty()) return false;
+            Range& front = q.ranges.front();
+            out = { front.begin, std::min(front.end, front.begin + chunk_size_) };
+            front.begin = out.end;
+            if (front.begin == front.end) q.ranges.pop_front();
+            return true;
+        }
+
+        // Steal the back half of another worker's last range.
+        bool steal(unsigned self, Range& out)
+        {
+            for (unsigned k = 1; k < size(); ++k) {
+                Queue& victim = queues_[(self + k) % size()];
+                Range stolen;
+                {
+                    std::lock_guard lock(victim.mutex);
+                    if (victim.ranges.empty()) continue;
+                    Range& back = victim.ranges.back();
+                    const size_t len = back.end - back.begin;
+                    const size_t take = len > chunk_size_ ? len / 2 : len;
+                    stolen = { back.end - take, back.end };
+                    back.end = stolen.begin;
+                    if (back.begin == back.end) victim.ranges.pop_back();
+                }
+
+                // Keep one chunk to run now, queue the rest locally. The victim's
+                // lock is released first so two thieves never hold both locks.
+                out = { stolen.begin, std::min(stolen.end, stolen.begin + chunk_size_) };
+                if (out.end < stolen.end) {
+                    std::lock_guard own(queues_[self].mutex);
+                    queues_[self].ranges.push_back({ out.end, stolen.end });
+                }
+                return true;
+            }
+            return false;
+        }
+
+        void run(unsigned self)
+        {
+            size_t seen = 0;
+            for (;;) {
+                {
+                    std::unique_lock lock(mutex_);
+                    wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                    if (stop_) return;
+                    seen = generation_;
+                }
+
+                Range r;
+                while (pop_local(self, r) || steal(self, r)) {
+                    job_(r.begin, r.end, self);
+                    if (remaining_.fetch_sub(r.end - r.begin, std::memory_order_acq_rel) == r.end - r.begin) {
+                        std::lock_guard lock(mutex_);
+                        done_.notify_all();
+                    }
+                }
+            }
+        }
+
+        size_t chunk_size_;
+        std::vector<Queue> queues_;
+        std::vector<std::thread> workers_;
+
+        std::function<void(size_t, size_t, unsigned)> job_;
+        std::atomic<size_t> remaining_{ 0 };
+
+        std::mutex submit_mutex_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+        size_t generation_ = 0;
+        bool stop_ = false;
+    };
+
+    // Stock reducers for parallel_evaluate. A reducer is copied once per
+    // worker, fed every value with operator(), then merged into the result.
+    struct ChecksumReducer {
+        unsigned long long sum = 0;
+        void operator()(unsigned short value) noexcept { sum += value; }
+        void merge(const ChecksumReducer& other) noexcept { sum += other.sum; }
+    };
+
+    struct CategoryReducer {
+        unsigned long long sum = 0;
+        std::array<unsigned long long, 10> freq{};
+        void operator()(unsigned short value) noexcept { sum += value; ++freq[hand_rank(value)]; }
+        void merge(const CategoryReducer& other) noexcept
+        {
+            sum += other.sum;
+            for (int i = 0; i < 10; ++i) freq[i] += other.freq[i];
+        }
+    };
+
+    // Evaluate every hand of the batch on the pool with `eval` and fold the
+    // values into per-worker copies of `reducer`, merged once at the end.
+    // `reducer` should be empty: each worker starts from a copy of it.
+    template<size_t N, typename Reducer, typename Eval>
+    [[nodiscard]] Reducer parallel_evaluate(ThreadPool& pool, std::span<const std::array<int, N>> batch,
+                                            Reducer reducer, Eval eval)
+    {
+        struct alignas(64) Slot { Reducer r; };
+        std::vector<Slot> partial(pool.size(), Slot{ reducer });
+
+        pool.parallel_for(batch.size(), [&](size_t begin, size_t end, unsigned worker) {
+            Reducer local = partial[worker].r;
+            for (size_t i = begin; i < end; ++i)
+                local(eval(Hand{ batch[i] }));
+            partial[worker].r = local;
+        });
+
+        for (size_t i = 1; i < partial.size(); ++i)
+            partial[0].r.merge(partial[i].r);
+        return partial[0].r;
+    }
+
+    // Same, with the evaluator picked from the card count (5 or 7).
+    template<size_t N, typename Reducer>
+    [[nodiscard]] Reducer parallel_evaluate(ThreadPool& pool, std::span<const std::array<int, N>> batch,
+                                            Reducer reducer)
+    {
+        static_assert(N == 5 || N == 7, "Only 5-card and 7-card evaluation supported");
+        if constexpr (N == 5)
+            return parallel_evaluate(pool, batch, reducer, [](Hand h) { return eval_5hand(h); });
+        else
+            return parallel_evaluate(pool, batch, reducer, [](Hand h) { return eval_7hand(h); });
+    }
+
+} // namespace poker
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define POKER_HAS_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define POKER_HAS_TSC 1
+#else
+#define POKER_HAS_TSC 0
+#endif
+
+/****************************************************************
+    Time-stamp counter
+
+    Cycle-level timing of short code sections:
+
+        const uint64_t t0 = tsc_start();
+        ... timed code ...
+        const uint64_t t1 = tsc_stop();
+
+    tsc_start fences so earlier instructions cannot drift into the
+    timed section; tsc_stop uses rdtscp, which waits for the timed
+    code to finish, and fences again so later code cannot start
+    before the read. The pair still costs a few dozen ticks, which
+    tsc_overhead measures so callers can subtract it.
+
+    Without an x86 TSC both read steady_clock in nanoseconds, so
+    tsc_ticks_per_ns() is then 1 and callers need no special case.
+****************************************************************/
+
+namespace poker {
+
+    inline constexpr bool HAS_TSC = POKER_HAS_TSC != 0;
+
+#if POKER_HAS_TSC
+    inline uint64_t tsc_start() noexcept
+    {
+        _mm_lfence();
+        const uint64_t t = __rdtsc();
+        _mm_lfence();
+        return t;
+    }
+
+    inline uint64_t tsc_stop() noexcept
+    {
+        unsigned aux;
+        const uint64_t t = __rdtscp(&aux);
+        _mm_lfence();
+        return t;
+    }
+#else
+    inline uint64_t tsc_start() noexcept
+    {
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+
+    inline uint64_t tsc_stop() noexcept { return tsc_start(); }
+#endif
+
+    // Cost of an empty tsc_start / tsc_stop pair: the minimum over `runs`
+    // tries, which is what a timed section pays at best.
+    [[nodiscard]] inline uint64_t tsc_overhead(int runs = 100'000) noexcept
+    {
+        uint64_t best = UINT64_MAX;
+        for (int i = 0; i < runs; ++i) {
+            const uint64_t t0 = tsc_start();
+            const uint64_t t1 = tsc_stop();
+            best = std::min(best, t1 - t0);
+        }
+        return best;
+    }
+
+    // Counter ticks per nanosecond, calibrated against steady_clock.
+    [[nodiscard]] inline double tsc_ticks_per_ns(std::chrono::milliseconds window = std::chrono::milliseconds{ 50 })
+    {
+        using clock = std::chrono::steady_clock;
+        const auto c0 = clock::now();
+        const uint64_t t0 = tsc_start();
+        std::this_thread::sleep_for(window);
+        const uint64_t t1 = tsc_stop();
+        const auto c1 = clock::now();
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(c1 - c0).count();
+        return ns > 0 ? static_cast<double>(t1 - t0) / static_cast<double>(ns) : 1.0;
+    }
+
+} // namespace poker
@@ -0,0 +1,96 @@
+#include <cstdint>
+#include "Poker.h"
+#include "BatchEval.h"
+#include "PokerEvalLib.h"
+
+/****************************************************************
+    PokerEval C API implementation
+
+    Each batch entry point validates and converts a hand's cards
+    to Cactus Kev form on the stack, evaluates it, and writes the
+    value, so the caller's buffers are only read and written once
+    (BatchEval.h, shared with the Python module). Exceptions never
+    cross the C boundary.
+****************************************************************/
+
+using namespace poker;
+
+namespace {
+
+    template<int N, typename From, typename T>
+    pe_status eval_checked(const T* cards, size_t count, uint16_t* values, uint32_t flags) noexcept
+    {
+        if (count == 0) return PE_OK;
+        if (!cards || !values || (flags & ~PE_PARALLEL)) return PE_INVALID_ARGUMENT;
+
+        try {
+            const bool ok = poker::eval_batch<N, From>(cards, count, values, (flags & PE_PARALLEL) != 0);
+            return ok ? PE_OK : PE_INVALID_CARD;
+        }
+        catch (...) {
+            return PE_INTERNAL_ERROR;
+        }
+    }
+
+} // anonymous namespace
+
+extern "C" {
+
+    PE_API uint32_t pe_version(void)
+    {
+        return PE_API_VERSION;
+    }
+
+    PE_API pe_status pe_eval5_indices(const uint8_t* cards, size_t count, uint16_t* values, uint32_t flags)
+    {
+        return eval_checked<5, IndexCards>(cards, count, values, flags);
+    }
+
+    PE_API pe_status pe_eval7_indices(const uint8_t* cards, size_t count, uint16_t* values, uint32_t flags)
+    {
+        return eval_checked<7, IndexCards>(cards, count, values, flags);
+    }
+
+    PE_API pe_status pe_eval5_cards(const int32_t* cards, size_t count, uint16_t* values, uint32_t flags)
+    {
+        return eval_checked<5, KevCards>(cards, count, values, flags);
+    }
+
+    PE_API pe_status pe_eval7_cards(const int32_t* cards, size_t count, uint16_t* values, uint32_t flags)
+    {
+        return eval_checked<7, KevCards>(cards, count, values, flags);
+    }
+
+    PE_API pe_status pe_categories(const uint16_t* values, size_t count, uint8_t* categories)
+    {
+        if (count == 0) return PE_OK;
+        if (!values || !categories) return PE_INVALID_ARGUMENT;
+        for (size_t i = 0; i < count; ++i) {
+            const uint16_t v = values[i];
+            categories[i] = static_cast<uint8_t>((v == 0 || v > 7462) ? 0 : hand_rank(v));
+        }
+        return PE_OK;
+    }
+
+    PE_API const char* pe_category_name(int category)
+    {
+        return (category >= 1 && category <= 9) ? value_str[category].data() : "";
+    }
+
+    PE_API int32_t pe_card(int index)
+    {
+        return (index >= 0 && index < 52) ? card_table[index] : -1;
+    }
+
+    PE_API const char* pe_status_string(pe_status status)
+    {
+        switch (status) {
+        case PE_OK: return "ok";
+        case PE_INVALID_ARGUMENT: return "invalid argument";
+        case PE_INVALID_CARD: return "invalid or repeated card";
+        case PE_INTERNAL_ERROR: return "internal error";
+        }
+        return "unknown status";
+    }
+
+} // extern "C"
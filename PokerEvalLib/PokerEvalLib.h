@@ -0,0 +1,82 @@
+#ifndef POKEREVAL_LIB_H
+#define POKEREVAL_LIB_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/****************************************************************
+    PokerEval C API
+
+    A plain C interface to the evaluators for FFI callers (Python
+    ctypes/cffi, Rust, Go, ...). Every entry point works on whole
+    caller-owned buffers, so one call covers any number of hands:
+
+        uint8_t cards[n][7];      deck indices, suit * 13 + rank
+        uint16_t values[n];
+        pe_eval7_indices(&cards[0][0], n, values, PE_PARALLEL);
+
+    Deck indices run 0..51: clubs, diamonds, hearts, spades, each
+    from deuce (0) to ace (12). The *_cards variants take Cactus
+    Kev card integers instead (pe_card() converts). Values are
+    1 (royal flush) to 7462 (worst high card).
+
+    A hand with an out-of-range or repeated card gets value 0, the
+    rest of the batch is still evaluated, and the call returns
+    PE_INVALID_CARD. No function throws or keeps pointers to the
+    caller's buffers after returning.
+
+    With PE_PARALLEL, large batches are split across a thread pool
+    that is created on first use and shared by all calls.
+****************************************************************/
+
+#if defined(_WIN32)
+#  if defined(POKEREVAL_BUILD)
+#    define PE_API __declspec(dllexport)
+#  else
+#    define PE_API __declspec(dllimport)
+#  endif
+#else
+#  define PE_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PE_API_VERSION 1
+
+typedef enum pe_status {
+    PE_OK = 0,
+    PE_INVALID_ARGUMENT = 1,   /* null buffer with count > 0, unknown flag */
+    PE_INVALID_CARD = 2,       /* at least one hand had a bad or repeated card */
+    PE_INTERNAL_ERROR = 3
+} pe_status;
+
+/* Flags for the batch functions */
+#define PE_PARALLEL 1u
+
+/* PE_API_VERSION of the loaded library. */
+PE_API uint32_t pe_version(void);
+
+/* Batch evaluation: cards holds count * 5 (or count * 7) entries, values count entries. */
+PE_API pe_status pe_eval5_indices(const uint8_t* cards, size_t count, uint16_t* values, uint32_t flags);
+PE_API pe_status pe_eval7_indices(const uint8_t* cards, size_t count, uint16_t* values, uint32_t flags);
+PE_API pe_status pe_eval5_cards(const int32_t* cards, size_t count, uint16_t* values, uint32_t flags);
+PE_API pe_status pe_eval7_cards(const int32_t* cards, size_t count, uint16_t* values, uint32_t flags);
+
+/* Hand category (1 = straight flush .. 9 = high card, 0 for value 0) of each value. */
+PE_API pe_status pe_categories(const uint16_t* values, size_t count, uint8_t* categories);
+
+/* "Straight Flush" .. "High Card" for categories 1..9, "" otherwise. */
+PE_API const char* pe_category_name(int category);
+
+/* Cactus Kev card for a deck index, or -1 if index > 51. */
+PE_API int32_t pe_card(int index);
+
+PE_API const char* pe_status_string(pe_status status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* POKEREVAL_LIB_H */
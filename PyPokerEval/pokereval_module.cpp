@@ -0,0 +1,342 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include "Poker.h"
+#include "CardParser.h"
+#include "Equity.h"
+#include "Showdown.h"
+#include "BatchEval.h"
+
+/****************************************************************
+    pokereval Python module
+
+    Batch evaluation over the buffer protocol, so NumPy arrays,
+    memoryviews and array.array objects are read in place without
+    the NumPy C headers:
+
+        values = pokereval.evaluate(hands)          # hands: (n, 5) or (n, 7)
+        pokereval.evaluate(hands, out=values)       # reuse an output buffer
+        eq, exact, boards = pokereval.equity(["AhAs", "KdKc"], board="Kh7c2d")
+
+    hands must be C-contiguous uint8 deck indices (suit * 13 +
+    rank) or int32 cards, where each int32 is either a deck index
+    or a Cactus Kev card. Hands with a bad or repeated card get
+    value 0. Results are a numpy.uint16 array when NumPy is
+    installed and an array.array('H') otherwise.
+
+    The GIL is released while evaluating; with parallel=True (the
+    default) large batches run on a thread pool shared by all
+    calls (BatchEval.h, shared with the C library).
+
+    showdown() and equity() raise ValueError when a card appears
+    twice among the board and hole cards.
+****************************************************************/
+
+using namespace poker;
+
+namespace {
+
+    // Buffer element type from a struct-module format string ("B", "<i", "=l", ...)
+    char element_type(const Py_buffer& view)
+    {
+        std::string_view fmt = view.format ? view.format : "B";
+        if (!fmt.empty() && (fmt[0] == '<' || fmt[0] == '=' || fmt[0] == '@')) fmt.remove_prefix(1);
+        if (fmt.size() != 1) return 0;
+        if ((fmt[0] == 'B') && view.itemsize == 1) return 'B';
+        if ((fmt[0] == 'i' || fmt[0] == 'l') && view.itemsize == 4) return 'i';
+        if (fmt[0] == 'H' && view.itemsize == 2) return 'H';
+        return 0;
+    }
+
+    // A new uint16 array of n elements: numpy.empty(n, numpy.uint16), else array.array('H').
+    PyObject* new_uint16_array(Py_ssize_t n)
+    {
+        if (PyObject* numpy = PyImport_ImportModule("numpy")) {
+            PyObject* result = PyObject_CallMethod(numpy, "empty", "(ns)", n, "uint16");
+            Py_DECREF(numpy);
+            return result;
+        }
+        PyErr_Clear();
+
+        PyObject* array = PyImport_ImportModule("array");
+        if (!array) return nullptr;
+        PyObject* zeros = PyBytes_FromStringAndSize(nullptr, n * 2);
+        if (!zeros) {
+            Py_DECREF(array);
+            return nullptr;
+        }
+        std::memset(PyBytes_AS_STRING(zeros), 0, static_cast<size_t>(n) * 2);
+        PyObject* result = PyObject_CallMethod(array, "array", "(sO)", "H", zeros);
+        Py_DECREF(zeros);
+        Py_DECREF(array);
+        return result;
+    }
+
+    // Parse up to max cards written as "AhKd", "Ah Kd" or "Ah,Kd" into Cactus Kev cards.
+    int parse_card_text(PyObject* obj, int* out, int max_cards)
+    {
+        Py_ssize_t len;
+        const char* s = PyUnicode_AsUTF8AndSize(obj, &len);
+        if (!s) return -1;
+        int n = 0;
+        for (Py_ssize_t i = 0; i < len; ) {
+            if (is_blank(s[i])) {
+                ++i;
+                continue;
+            }
+            const int card = (i + 1 < len) ? parse_card(s + i) : -1;
+            if (card < 0 || n == max_cards) {
+                PyErr_Format(PyExc_ValueError, "invalid cards: '%s'", s);
+                return -1;
+            }
+            out[n++] = card;
+            i += 2;
+        }
+        return n;
+    }
+
+    // Read board text and a sequence of two-card hole strings into a Showdown.
+    bool parse_showdown(PyObject* holes, PyObject* board, Showdown& s, int& board_cards)
+    {
+        board_cards = 0;
+        if (board) {
+            board_cards = parse_card_text(board, s.board.data(), 5);
+            if (board_cards < 0) return false;
+        }
+
+        PyObject* seq = PySequence_Fast(holes, "holes must be a sequence of two-card strings");
+        if (!seq) return false;
+        const Py_ssize_t players = PySequence_Fast_GET_SIZE(seq);
+        if (players < 1 || players > MAX_SEATS) {
+            Py_DECREF(seq);
+            PyErr_Format(PyExc_ValueError, "need 1 to %d players", MAX_SEATS);
+            return false;
+        }
+        s.players = static_cast<int>(players);
+        for (Py_ssize_t p = 0; p < players; ++p) {
+            const int n = parse_card_text(PySequence_Fast_GET_ITEM(seq, p), s.holes[p].data(), 2);
+            if (n != 2) {
+                Py_DECREF(seq);
+                if (n >= 0) PyErr_SetString(PyExc_ValueError, "each player needs exactly two hole cards");
+                return false;
+            }
+        }
+        Py_DECREF(seq);
+
+        // Every card at most once across the board and all holes
+        uint64_t seen = 0;
+        auto fresh = [&seen](int card) {
+            const uint64_t bit = uint64_t{ 1 } << kev_card_index(card);
+            if (seen & bit) return false;
+            seen |= bit;
+            return true;
+        };
+        bool ok = true;
+        for (int i = 0; i < board_cards; ++i) ok &= fresh(s.board[i]);
+        for (int p = 0; p < s.players; ++p) ok &= fresh(s.holes[p][0]) && fresh(s.holes[p][1]);
+        if (!ok) {
+            PyErr_SetString(PyExc_ValueError, "repeated card");
+            return false;
+        }
+        return true;
+    }
+
+    PyObject* py_evaluate(PyObject*, PyObject* args, PyObject* kwargs)
+    {
+        static const char* keywords[] = { "hands", "out", "parallel", nullptr };
+        PyObject* hands_obj = nullptr;
+        PyObject* out_obj = Py_None;
+        int parallel = 1;
+        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|Op", const_cast<char**>(keywords),
+                &hands_obj, &out_obj, &parallel))
+            return nullptr;
+
+        Py_buffer in;
+        if (PyObject_GetBuffer(hands_obj, &in, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | PyBUF_ND) != 0)
+            return nullptr;
+
+        const char type = element_type(in);
+        const int cards = in.ndim == 2 ? static_cast<int>(in.shape[1]) : 0;
+        if ((type != 'B' && type != 'i') || (cards != 5 && cards != 7)) {
+            PyBuffer_Release(&in);
+            PyErr_SetString(PyExc_ValueError, "hands must be a C-contiguous (n, 5) or (n, 7) uint8 or int32 array");
+            return nullptr;
+        }
+        const Py_ssize_t count = in.shape[0];
+
+        PyObject* result = (out_obj == Py_None) ? new_uint16_array(count) : (Py_INCREF(out_obj), out_obj);
+        if (!result) {
+            PyBuffer_Release(&in);
+            return nullptr;
+        }
+
+        Py_buffer out;
+        if (PyObject_GetBuffer(result, &out, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | PyBUF_WRITABLE) != 0) {
+            PyBuffer_Release(&in);
+            Py_DECREF(result);
+            return nullptr;
+        }
+        if (element_type(out) != 'H' || out.len != count * 2) {
+            PyBuffer_Release(&out);
+            PyBuffer_Release(&in);
+            Py_DECREF(result);
+            PyErr_SetString(PyExc_ValueError, "out must be a writable uint16 buffer with one element per hand");
+            return nullptr;
+        }
+
+        auto* values = static_cast<uint16_t*>(out.buf);
+        const size_t n = static_cast<size_t>(count);
+        bool failed = false;
+        Py_BEGIN_ALLOW_THREADS
+        try {
+            // A bad hand is reported through its value 0, not an exception
+            if (type == 'B') {
+                const auto* p = static_cast<const uint8_t*>(in.buf);
+                (void)(cards == 5 ? eval_batch<5, IndexCards>(p, n, values, parallel)
+                                  : eval_batch<7, IndexCards>(p, n, values, parallel));
+            } else {
+                const auto* p = static_cast<const int32_t*>(in.buf);
+                (void)(cards == 5 ? eval_batch<5, IndexOrKevCards>(p, n, values, parallel)
+                                  : eval_batch<7, IndexOrKevCards>(p, n, values, parallel));
+            }
+        }
+        catch (...) {
+            failed = true;
+        }
+        Py_END_ALLOW_THREADS
+
+        PyBuffer_Release(&out);
+        PyBuffer_Release(&in);
+        if (failed) {
+            Py_DECREF(result);
+            PyErr_SetString(PyExc_RuntimeError, "evaluation failed");
+            return nullptr;
+        }
+        return result;
+    }
+
+    PyObject* py_category(PyObject*, PyObject* arg)
+    {
+        const long v = PyLong_AsLong(arg);
+        if (v == -1 && PyErr_Occurred()) return nullptr;
+        return PyLong_FromLong((v < 1 || v > 7462) ? 0 : hand_rank(static_cast<unsigned short>(v)));
+    }
+
+    PyObject* py_equity(PyObject*, PyObject* args, PyObject* kwargs)
+    {
+        static const char* keywords[] = { "holes", "board", "max_boards", "seed", nullptr };
+        PyObject* holes = nullptr;
+        PyObject* board = nullptr;
+        unsigned long long max_boards = 0;
+        unsigned long long seed = 1;
+        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|UKK", const_cast<char**>(keywords),
+                &holes, &board, &max_boards, &seed))
+            return nullptr;
+
+        Showdown s;
+        int board_cards;
+        if (!parse_showdown(holes, board, s, board_cards)) return nullptr;
+
+        EquityResult r;
+        const char* error = nullptr;
+        Py_BEGIN_ALLOW_THREADS
+        try {
+            r = evaluate_equity(s, board_cards, max_boards, seed);
+        }
+        catch (const std::invalid_argument&) {
+            error = "repeated card";
+        }
+        Py_END_ALLOW_THREADS
+        if (error) {
+            PyErr_SetString(PyExc_ValueError, error);
+            return nullptr;
+        }
+
+        PyObject* eq = PyTuple_New(s.players);
+        if (!eq) return nullptr;
+        for (int p = 0; p < s.players; ++p)
+            PyTuple_SET_ITEM(eq, p, PyFloat_FromDouble(r.equity[p]));
+        return Py_BuildValue("(NOK)", eq, r.exact ? Py_True : Py_False, static_cast<unsigned long long>(r.boards));
+    }
+
+    PyObject* py_showdown(PyObject*, PyObject* args)
+    {
+        PyObject* board = nullptr;
+        PyObject* holes = nullptr;
+        if (!PyArg_ParseTuple(args, "UO", &board, &holes)) return nullptr;
+
+        Showdown s;
+        int board_cards;
+        if (!parse_showdown(holes, board, s, board_cards)) return nullptr;
+        if (board_cards != 5) {
+            PyErr_SetString(PyExc_ValueError, "a showdown needs five board cards");
+            return nullptr;
+        }
+
+        const ShowdownResult r = evaluate_showdown(s);
+        PyObject* values = PyTuple_New(s.players);
+        PyObject* winners = PyList_New(0);
+        if (!values || !winners) {
+            Py_XDECREF(values);
+            Py_XDECREF(winners);
+            return nullptr;
+        }
+        for (int p = 0; p < s.players; ++p) {
+            PyTuple_SET_ITEM(values, p, PyLong_FromLong(r.values[p]));
+            if (r.winners >> p & 1) {
+                PyObject* seat = PyLong_FromLong(p);
+                PyList_Append(winners, seat);
+                Py_DECREF(seat);
+            }
+        }
+        return Py_BuildValue("(NN)", values, winners);
+    }
+
+    PyMethodDef methods[] = {
+        { "evaluate", reinterpret_cast<PyCFunction>(reinterpret_cast<void(*)()>(py_evaluate)), METH_VARARGS | METH_KEYWORDS,
+          "evaluate(hands, out=None, parallel=True)\n\n"
+          "Values (1 = royal flush .. 7462) of an (n, 5) or (n, 7) uint8/int32 array of hands.\n"
+          "Hands with a bad or repeated card get 0." },
+        { "category", py_category, METH_O,
+          "category(value)\n\nHand category, 1 (straight flush) .. 9 (high card), or 0." },
+        { "equity", reinterpret_cast<PyCFunction>(reinterpret_cast<void(*)()>(py_equity)), METH_VARARGS | METH_KEYWORDS,
+          "equity(holes, board='', max_boards=0, seed=1)\n\n"
+          "Hold'em equity of each player's hole cards ('AhKd') given 0-5 board cards.\n"
+          "Returns (equities, exact, boards); sampled when there are more than max_boards run-outs." },
+        { "showdown", py_showdown, METH_VARARGS,
+          "showdown(board, holes)\n\nReturns (values, winners) for a five-card board and each player's hole cards." },
+        { nullptr, nullptr, 0, nullptr }
+    };
+
+    PyModuleDef module_def = {
+        PyModuleDef_HEAD_INIT, "pokereval",
+        "Cactus Kev poker hand evaluator: batch evaluation, showdowns and equity.",
+        -1, methods, nullptr, nullptr, nullptr, nullptr
+    };
+
+} // anonymous namespace
+
+PyMODINIT_FUNC PyInit_pokereval(void)
+{
+    PyObject* m = PyModule_Create(&module_def);
+    if (!m) return nullptr;
+
+    PyObject* names = PyTuple_New(10);
+    if (!names) {
+        Py_DECREF(m);
+        return nullptr;
+    }
+    for (int i = 0; i < 10; ++i)
+        PyTuple_SET_ITEM(names, i, PyUnicode_FromStringAndSize(value_str[i].data(), static_cast<Py_ssize_t>(value_str[i].size())));
+    if (PyModule_AddObject(m, "CATEGORY_NAMES", names) != 0) {
+        Py_DECREF(names);
+        Py_DECREF(m);
+        return nullptr;
+    }
+    return m;
+}
@@ -0,0 +1,37 @@
+"""Build the pokereval extension module.
+
+Needs only a C++23 compiler and the Python headers (no NumPy headers):
+
+    python setup.py build_ext --inplace
+    python smoke_test.py
+"""
+
+import os
+import sys
+
+from setuptools import Extension, setup
+
+here = os.path.dirname(os.path.abspath(__file__))
+
+if sys.platform == "win32":
+    compile_args = ["/std:c++latest", "/O2", "/EHsc"]
+    link_args = []
+else:
+    compile_args = ["-std=c++2b", "-O3", "-fvisibility=hidden"]
+    link_args = ["-pthread"]
+
+setup(
+    name="pokereval",
+    version="1.0",
+    description="Cactus Kev poker hand evaluator with zero-copy batch evaluation",
+    ext_modules=[
+        Extension(
+            "pokereval",
+            sources=[os.path.join(here, "pokereval_module.cpp")],
+            include_dirs=[os.path.join(here, "..", "PokerEval")],
+            language="c++",
+            extra_compile_args=compile_args,
+            extra_link_args=link_args,
+        )
+    ],
+)
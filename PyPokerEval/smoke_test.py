@@ -0,0 +1,74 @@
+"""Smoke test for the built pokereval module; needs no network and no NumPy.
+
+    python setup.py build_ext --inplace
+    python smoke_test.py
+
+Exits 1 on the first failed check.
+"""
+
+import array
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+
+import pokereval  # noqa: E402
+
+RANKS = "23456789TJQKA"
+SUITS = "cdhs"
+
+
+def index(card):
+    """Deck index (suit * 13 + rank) of a card such as 'Ah'."""
+    return SUITS.index(card[1]) * 13 + RANKS.index(card[0])
+
+
+def hands(rows, fmt):
+    """A C-contiguous (n, cards) buffer of deck indices."""
+    flat = array.array(fmt, [index(c) for row in rows for c in row.split()])
+    return memoryview(flat).cast("B").cast(fmt, (len(rows), len(rows[0].split())))
+
+
+def check(name, got, expected):
+    if got != expected:
+        print(f"FAIL {name}: got {got!r}, expected {expected!r}")
+        sys.exit(1)
+    print(f"ok   {name}")
+
+
+def raises(name, fn):
+    try:
+        fn()
+    except ValueError:
+        print(f"ok   {name}")
+        return
+    print(f"FAIL {name}: no ValueError")
+    sys.exit(1)
+
+
+five = hands(["Ac Kc Qc Jc Tc", "7h 5d 4c 3s 2h", "Ac Ac Kd Qs Jh"], "B")
+check("evaluate 5-card uint8", list(pokereval.evaluate(five)), [1, 7462, 0])
+
+seven = hands(["As Ks Qs Js Ts 2c 3d", "Ah Ad Ac Kh Kd 2s 3c"], "i")
+values = pokereval.evaluate(seven, parallel=False)
+check("evaluate 7-card int32", values[0], 1)
+check("full house category", pokereval.category(values[1]), 3)
+
+out = array.array("H", [9, 9, 9])
+pokereval.evaluate(five, out=out)
+check("evaluate into out=", list(out), [1, 7462, 0])
+
+check("category names", pokereval.CATEGORY_NAMES[1], "Straight Flush")
+
+vals, winners = pokereval.showdown("2c 7d 9s Js Qs", ["AsKs", "3c3d"])
+check("showdown winner", winners, [0])
+raises("showdown repeated hole card", lambda: pokereval.showdown("2c 7d 9h Js Qs", ["AhAh", "3c3d"]))
+raises("showdown card on board and in a hole", lambda: pokereval.showdown("2c 7d 9h Js Qs", ["AsKs", "2c3d"]))
+
+eq, exact, boards = pokereval.equity(["AhAs", "KdKc"], board="Kh7c2d")
+check("equity is exact on the turn and river", (exact, boards), (True, 990))
+check("equity sums to 1", round(sum(eq), 9), 1.0)
+raises("equity repeated card", lambda: pokereval.equity(["AhAh", "KdKc"]))
+raises("equity card on board and in a hole", lambda: pokereval.equity(["AhAs", "KdKc"], board="Kd7c2d"))
+
+print("all checks passed")
@@ -0,0 +1,407 @@
+#include <print>
+#include <chrono>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <numeric>
+#include "Poker.h"
+#include "ThreadPool.h"
+#include "Evaluators.h"
+
+/****************************************************************
+    Differential evaluator verification
+
+    Checks every registered evaluator (Evaluators.h) against the
+    reference eval_5cards / eval_7hand before it goes on a hot path:
+
+      5, 7      every one of the C(52,5) / C(52,7) hands; both the
+                batch entry (values) and, where there is one, the
+                single-hand entry are compared
+      6, 8, 9   seeded random hands. The reference is the best of
+                all five-card subsets; an evaluator for k cards is
+                scored as the best over all k-card subsets, fed to
+                it as one batch
+
+    Work is split into (first, second card) prefixes or blocks of
+    random hands; workers enumerate into their own buffers. The
+    first mismatch stops all workers and is printed with
+    print_hand; the exit code is then 1. Each phase reports its
+    verification throughput. An unknown --evaluator name is a
+    usage error (exit 2). A run that checks nothing, or skips a
+    size named by --cards because no evaluator applies, exits 1.
+
+    Usage: Verify [--cards 5,7,6,8,9] [--evaluator NAME,...]
+                  [--samples N] [--seed S] [--threads N]
+****************************************************************/
+
+using namespace poker;
+using namespace std::chrono;
+
+namespace {
+
+    // Hands per worker buffer
+    constexpr size_t VERIFY_BUFFER_HANDS = 4096;
+
+    // Random hands per sampled card count
+    constexpr long long DEFAULT_SAMPLES = 1'000'000;
+
+    constexpr uint64_t DEFAULT_SEED = 1;
+
+    struct Mismatch {
+        const Evaluator* evaluator = nullptr;
+        std::string_view entry;
+        std::vector<int> hand;
+        unsigned short expected = 0;
+        unsigned short got = 0;
+    };
+
+    // First mismatch found by any worker
+    class Failure {
+    public:
+        [[nodiscard]] bool failed() const noexcept { return failed_.load(std::memory_order_relaxed); }
+
+        void report(const Evaluator& e, std::string_view entry, const int* hand, int cards,
+                    unsigned short expected, unsigned short got)
+        {
+            std::lock_guard lock(mutex_);
+            if (failed_.exchange(true)) return;
+            first_ = { &e, entry, std::vector<int>(hand, hand + cards), expected, got };
+        }
+
+        void print() const
+        {
+            std::println("\nMISMATCH: evaluator '{}' ({}-card, {} entry) on {}-card hand",
+                first_.evaluator->name, first_.evaluator->cards, first_.entry, first_.hand.size());
+            std::print("  hand:     ");
+            print_hand(first_.hand);
+            std::println("");
+            std::println("  expected: {:4d} ({})", first_.expected, category_name(first_.expected));
+            std::println("  got:      {:4d} ({})", first_.got, category_name(first_.got));
+        }
+
+    private:
+        static std::string_view category_name(unsigned short v)
+        {
+            return (v >= 1 && v <= 7462) ? value_str[hand_rank(v)] : "invalid";
+        }
+
+        std::atomic<bool> failed_{ false };
+        std::mutex mutex_;
+        Mismatch first_;
+    };
+
+    // Per-worker buffers, padded so workers never share a cache line
+    struct alignas(64) Buffers {
+        std::vector<int> hands;
+        std::vector<unsigned short> expected;
+        std::vector<unsigned short> got;
+        std::vector<int> subsets;
+        std::vector<unsigned short> subset_values;
+    };
+
+    // Every k-element subset of {0..n-1}, in lexicographic order
+    std::vector<std::vector<int>> combinations(int n, int k)
+    {
+        std::vector<std::vector<int>> out;
+        std::vector<int> c(k);
+        std::iota(c.begin(), c.end(), 0);
+        for (;;) {
+            out.push_back(c);
+            int i = k - 1;
+            while (i >= 0 && c[i] == n - k + i) --i;
+            if (i < 0) return out;
+            ++c[i];
+            for (int j = i + 1; j < k; ++j) c[j] = c[j - 1] + 1;
+        }
+    }
+
+    // Compare count hands against expected with every evaluator; false on a mismatch.
+    bool check_exact(std::span<const Evaluator* const> evals, const int* hands, size_t count, int cards,
+                     const unsigned short* expected, std::vector<unsigned short>& got, Failure& failure)
+    {
+        for (const Evaluator* e : evals) {
+            e->values(hands, count, got.data());
+            for (size_t i = 0; i < count; ++i) {
+                const int* hand = hands + i * cards;
+                if (got[i] != expected[i]) {
+                    failure.report(*e, "batch", hand, cards, expected[i], got[i]);
+                    return false;
+                }
+                if (e->single) {
+                    const unsigned short v = e->single(hand);
+                    if (v != expected[i]) {
+                        failure.report(*e, "single", hand, cards, expected[i], v);
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    struct PhaseStats {
+        unsigned long long hands = 0;
+        double seconds = 0;
+    };
+
+    // All C(52, cards) hands, cards = 5 or 7
+    PhaseStats verify_exhaustive(ThreadPool& pool, int cards, std::span<const Evaluator* const> evals, Failure& failure)
+    {
+        const Deck deck = init_deck();
+        const int rest = cards - 2;
+
+        // Work items are the (a, b) prefixes that still leave `rest` cards above b
+        std::vector<std::array<int, 2>> prefixes;
+        for (int a = 0; a < 52 - cards + 1; ++a)
+            for (int b = a + 1; b < 52 - rest; ++b)
+                prefixes.push_back({ a, b });
+
+        std::vector<Buffers> buffers(pool.size());
+        std::atomic<unsigned long long> total{ 0 };
+        const auto start = steady_clock::now();
+
+        pool.parallel_for(prefixes.size(), [&](size_t begin, size_t end, unsigned w) {
+            Buffers& buf = buffers[w];
+            buf.hands.resize(VERIFY_BUFFER_HANDS * cards);
+            buf.expected.resize(VERIFY_BUFFER_HANDS);
+            buf.got.resize(VERIFY_BUFFER_HANDS);
+            unsigned long long done = 0;
+
+            auto flush = [&](size_t n) {
+                for (size_t i = 0; i < n; ++i) {
+                    const int* h = buf.hands.data() + i * cards;
+                    buf.expected[i] = cards == 5 ? eval_5cards(h[0], h[1], h[2], h[3], h[4]) : eval_7hand(Hand{ h, 7 });
+                }
+                done += n;
+                return check_exact(evals, buf.hands.data(), n, cards, buf.expected.data(), buf.got, failure);
+            };
+
+            for (size_t p = begin; p < end && !failure.failed(); ++p) {
+                const auto [a, b] = prefixes[p];
+                std::array<int, 5> c;          // the remaining cards, increasing
+                for (int j = 0; j < rest; ++j) c[j] = b + 1 + j;
+
+                size_t n = 0;
+                for (;;) {
+                    int* h = buf.hands.data() + n * cards;
+                    h[0] = deck[a];
+                    h[1] = deck[b];
+                    for (int j = 0; j < rest; ++j) h[2 + j] = deck[c[j]];
+                    if (++n == VERIFY_BUFFER_HANDS) {
+                        if (!flush(n)) return;
+                        n = 0;
+                    }
+
+                    int i = rest - 1;
+                    while (i >= 0 && c[i] == 52 - rest + i) --i;
+                    if (i < 0) break;
+                    ++c[i];
+                    for (int j = i + 1; j < rest; ++j) c[j] = c[j - 1] + 1;
+                }
+                if (n && !flush(n)) return;
+            }
+            total += done;
+        });
+
+        return { total.load(), duration_cast<nanoseconds>(steady_clock::now() - start).count() / 1e9 };
+    }
+
+    // Seeded random hands of `cards` cards (any count from 5 to 9)
+    PhaseStats verify_sampled(ThreadPool& pool, int cards, long long samples, uint64_t seed,
+                              std::span<const Evaluator* const> evals, Failure& failure)
+    {
+        const Deck deck = init_deck();
+        const auto ref_subsets = combinations(cards, 5);
+        std::array<std::vector<std::vector<int>>, 8> subsets;     // by evaluator card count
+        for (const Evaluator* e : evals)
+            subsets[e->cards] = combinations(cards, e->cards);
+
+        const size_t blocks = (static_cast<size_t>(samples) + VERIFY_BUFFER_HANDS - 1) / VERIFY_BUFFER_HANDS;
+        std::vector<Buffers> buffers(pool.size());
+        std::atomic<unsigned long long> total{ 0 };
+        const auto start = steady_clock::now();
+
+        pool.parallel_for(blocks, [&](size_t begin, size_t end, unsigned w) {
+            Buffers& buf = buffers[w];
+            buf.hands.resize(VERIFY_BUFFER_HANDS * cards);
+            buf.expected.resize(VERIFY_BUFFER_HANDS);
+            unsigned long long done = 0;
+
+            for (size_t block = begin; block < end && !failure.failed(); ++block) {
+                std::mt19937_64 gen(seed ^ (0x9E3779B97F4A7C15ULL * (block + 1)));
+                const size_t n = std::min<size_t>(VERIFY_BUFFER_HANDS, samples - block * VERIFY_BUFFER_HANDS);
+
+                // Deal, and score each hand as its best five-card subset
+                for (size_t i = 0; i < n; ++i) {
+                    std::array<int, 52> idx;
+                    std::iota(idx.begin(), idx.end(), 0);
+                    int* h = buf.hands.data() + i * cards;
+                    for (int j = 0; j < cards; ++j) {
+                        std::uniform_int_distribution<int> dist(j, 51);
+                        std::swap(idx[j], idx[dist(gen)]);
+                        h[j] = deck[idx[j]];
+                    }
+                    unsigned short best = 9999;
+                    for (const auto& s : ref_subsets)
+                        best = std::min(best, eval_5cards(h[s[0]], h[s[1]], h[s[2]], h[s[3]], h[s[4]]));
+                    buf.expected[i] = best;
+                }
+
+                // Each evaluator scores every subset of its size in one batch
+                for (const Evaluator* e : evals) {
+                    const auto& subs = subsets[e->cards];
+                    const size_t per_hand = subs.size();
+                    buf.subsets.resize(n * per_hand * e->cards);
+                    buf.subset_values.resize(n * per_hand);
+
+                    int* out = buf.subsets.data();
+                    for (size_t i = 0; i < n; ++i) {
+                        const int* h = buf.hands.data() + i * cards;
+                        for (const auto& s : subs)
+                            for (int j : s) *out++ = h[j];
+                    }
+                    e->values(buf.subsets.data(), n * per_hand, buf.subset_values.data());
+
+                    for (size_t i = 0; i < n; ++i) {
+                        const auto first = buf.subset_values.begin() + i * per_hand;
+                        const unsigned short got = *std::min_element(first, first + per_hand);
+                        if (got != buf.expected[i]) {
+                            failure.report(*e, "batch, best subset", buf.hands.data() + i * cards, cards, buf.expected[i], got);
+                            return;
+                        }
+                    }
+                }
+                done += n;
+            }
+            total += done;
+        });
+
+        return { total.load(), duration_cast<nanoseconds>(steady_clock::now() - start).count() / 1e9 };
+    }
+
+    // "5, 7" for the summary lines
+    std::string format_list(const std::vector<int>& items)
+    {
+        std::string out;
+        for (int n : items)
+            out += (out.empty() ? "" : ", ") + std::to_string(n);
+        return out;
+    }
+
+    std::vector<std::string> split(std::string_view list)
+    {
+        std::vector<std::string> items;
+        while (!list.empty()) {
+            const size_t comma = list.find(',');
+            items.emplace_back(list.substr(0, comma));
+            if (comma == std::string_view::npos) break;
+            list.remove_prefix(comma + 1);
+        }
+        return items;
+    }
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    std::vector<int> card_counts = { 5, 7, 6, 8, 9 };
+    std::vector<std::string> names;
+    long long samples = DEFAULT_SAMPLES;
+    uint64_t seed = DEFAULT_SEED;
+    unsigned threads = 0;
+    bool cards_given = false;
+    bool usage = false;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string_view arg = argv[i];
+            if (arg == "--cards" && i + 1 < argc) {
+                card_counts.clear();
+                cards_given = true;
+                for (const auto& c : split(argv[++i])) {
+                    const int n = std::stoi(c);
+                    if (n < 5 || n > 9) throw std::invalid_argument("--cards must be between 5 and 9");
+                    card_counts.push_back(n);
+                }
+                if (card_counts.empty()) throw std::invalid_argument("--cards needs at least one size");
+            }
+            else if (arg == "--evaluator" && i + 1 < argc) names = split(argv[++i]);
+            else if (arg == "--samples" && i + 1 < argc) samples = std::stoll(argv[++i]);
+            else if (arg == "--seed" && i + 1 < argc) seed = std::stoull(argv[++i]);
+            else if (arg == "--threads" && i + 1 < argc) threads = static_cast<unsigned>(std::stoul(argv[++i]));
+            else usage = true;
+        }
+        for (const auto& name : names) {
+            if (std::none_of(evaluators().begin(), evaluators().end(), [&](const Evaluator& e) { return e.name == name; }))
+                throw std::invalid_argument("unknown evaluator: " + name);
+        }
+    }
+    catch (const std::exception& e) {
+        std::println(stderr, "{}", e.what());
+        usage = true;
+    }
+    if (usage || samples <= 0) {
+        std::println(stderr, "Usage: Verify [--cards 5,7,6,8,9] [--evaluator NAME,...] [--samples N] [--seed S] [--threads N]");
+        return 2;
+    }
+
+    try {
+        ThreadPool pool({ .threads = threads, .chunk_size = 1 });
+        Failure failure;
+
+        std::println("=== Evaluator Verification ({} threads) ===", pool.size());
+        for (const Evaluator& e : evaluators())
+            if (names.empty() || std::find(names.begin(), names.end(), e.name) != names.end())
+                std::println("  {:<14s} {}-card  {}", e.name, e.cards, e.description);
+        std::println("");
+
+        std::vector<int> checked, skipped;
+        for (int cards : card_counts) {
+            // Evaluators that can score a hand of this size
+            std::vector<const Evaluator*> evals;
+            for (const Evaluator& e : evaluators()) {
+                const bool named = names.empty() || std::find(names.begin(), names.end(), e.name) != names.end();
+                const bool fits = (cards == 5 || cards == 7) ? e.cards == cards : e.cards <= cards;
+                if (named && fits) evals.push_back(&e);
+            }
+            if (evals.empty()) {
+                std::println("  {}-card: no evaluator applies, skipped", cards);
+                skipped.push_back(cards);
+                continue;
+            }
+
+            const bool exhaustive = cards == 5 || cards == 7;
+            const PhaseStats s = exhaustive ? verify_exhaustive(pool, cards, evals, failure)
+                                            : verify_sampled(pool, cards, samples, seed, evals, failure);
+            if (failure.failed()) {
+                failure.print();
+                return 1;
+            }
+            std::println("  {}-card {:<10s} {:>13L} hands x {} evaluator(s): {:8.3f} s, {:8.2f}M hands/sec",
+                cards, exhaustive ? "exhaustive" : "sampled", s.hands, evals.size(), s.seconds, s.hands / s.seconds / 1e6);
+            checked.push_back(cards);
+        }
+
+        // A gate that checked nothing must not pass; nor may one that skipped a size asked for by --cards
+        if (checked.empty() || (cards_given && !skipped.empty())) {
+            std::println(stderr, "\nNo evaluator checked {}-card hands.", format_list(skipped));
+            return 1;
+        }
+        if (!skipped.empty()) {
+            std::println("\nEvaluators agree with the reference on {}-card hands; none applies to {}-card.",
+                format_list(checked), format_list(skipped));
+            return 0;
+        }
+        std::println("\nAll evaluators agree with the reference.");
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::println(stderr, "{}", e.what());
+        return 1;
+    }
+}